@@ -6,19 +6,33 @@
 #include <fstream>
 #include <stdexcept>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 #include "../Models/Project_path.h"
 #include "../Models/Move.h"
+#include "Spsc_queue.h"
+#include "Latency_probe.h"
+#include "Trace.h"
 
 using namespace std;
 
 // Класс Board отвечает за графическую часть игры:
 // хранение состояния доски, отрисовку фигур, подсветку ходов,
 // обработку истории и отображение результата.
+// Окно, события и отрисовка живут в главном потоке (SDL требует этого для рендерера и событий, macOS — строго),
+// игра и боты — в потоке игры. Каждое изменение состояния поток игры отправляет снимком (Frame) через очередь
+// без блокировок, главный поток плавно анимирует ходы с частотой обновления экрана, а события окна передаёт
+// потоку игры (wait_event). Поток игры отрисовки не ждёт.
 class Board
 {
 public:
-    int W = 0; // ширина окна
-    int H = 0; // высота окна
+    atomic<int> W{ 0 }; // ширина окна (читает и поток игры)
+    atomic<int> H{ 0 }; // высота окна
 
     // история состояний доски (для отката ходов)
     vector<vector<vector<POS_T>>> history_mtx;
@@ -26,9 +40,13 @@ public:
     Board() = default;
 
     // Конструктор с параметрами: принимает размеры окна
-    Board(const unsigned int W, const unsigned int H) : W(W), H(H) {}
+    // move_ms — длительность анимации хода на одну клетку (0 — без анимации)
+    Board(const unsigned int W, const unsigned int H, const int move_ms = 150) : W(W), H(H), move_ms(move_ms) {}
 
-    // Инициализация SDL, создание окна и загрузка текстур
+    Board(const Board&) = delete;
+    Board& operator=(const Board&) = delete;
+
+    // Инициализация SDL, создание окна, рендерера и загрузка текстур (в главном потоке)
     int start_draw()
     {
         if (SDL_Init(SDL_INIT_EVERYTHING) != 0)
@@ -44,9 +62,8 @@ public:
                 print_exception("SDL_GetDesktopDisplayMode can't get desktop display mode");
                 return 1;
             }
-            W = min(dm.w, dm.h);
-            W -= W / 15;
-            H = W;
+            W = min(dm.w, dm.h) - min(dm.w, dm.h) / 15;
+            H = W.load();
         }
         win = SDL_CreateWindow("Checkers", 0, H / 30, W, H, SDL_WINDOW_RESIZABLE);
         if (win == nullptr)
@@ -55,28 +72,23 @@ public:
             return 1;
         }
         ren = SDL_CreateRenderer(win, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+        if (ren == nullptr)
+            ren = SDL_CreateRenderer(win, -1, 0); // без ускорения (например, драйвер dummy)
         if (ren == nullptr)
         {
             print_exception("SDL_CreateRenderer can't create renderer");
             return 1;
         }
-
-        // загрузка текстур
-        board = IMG_LoadTexture(ren, board_path.c_str());
-        w_piece = IMG_LoadTexture(ren, piece_white_path.c_str());
-        b_piece = IMG_LoadTexture(ren, piece_black_path.c_str());
-        w_queen = IMG_LoadTexture(ren, queen_white_path.c_str());
-        b_queen = IMG_LoadTexture(ren, queen_black_path.c_str());
-        back = IMG_LoadTexture(ren, back_path.c_str());
-        replay = IMG_LoadTexture(ren, replay_path.c_str());
-
-        if (!board || !w_piece || !b_piece || !w_queen || !b_queen || !back || !replay)
+        if (!load_textures())
         {
-            print_exception("IMG_LoadTexture can't load main textures from " + textures_path);
+            print_exception("IMG_LoadTexture can't load textures from " + textures_path);
+            free_textures();
             return 1;
         }
+        SDL_RendererInfo info;
+        vsync = !SDL_GetRendererInfo(ren, &info) && (info.flags & SDL_RENDERER_PRESENTVSYNC);
 
-        SDL_GetRendererOutputSize(ren, &W, &H);
+        update_window_size(); // в координатах окна приходят и клики мыши
         make_start_mtx();
         rerender();
         return 0;
@@ -93,31 +105,33 @@ public:
         clear_highlight();
     }
 
-    // Перемещение фигуры (через структуру move_pos)
+    // Перемещение фигуры (через структуру move_pos); ход анимируется
     void move_piece(move_pos turn, const int beat_series = 0)
     {
+        if (mtx[turn.x2][turn.y2])
+            throw runtime_error("final position is not empty, can't move");
+        if (!mtx[turn.x][turn.y])
+            throw runtime_error("begin position is empty, can't move");
         if (turn.xb != -1)
         {
             mtx[turn.xb][turn.yb] = 0; // удаляем побитую шашку
         }
-        move_piece(turn.x, turn.y, turn.x2, turn.y2, beat_series);
+
+        // превращение в дамку
+        if ((mtx[turn.x][turn.y] == 1 && turn.x2 == 0) || (mtx[turn.x][turn.y] == 2 && turn.x2 == 7))
+            mtx[turn.x][turn.y] += 2;
+
+        mtx[turn.x2][turn.y2] = mtx[turn.x][turn.y];
+        mtx[turn.x][turn.y] = 0;
+        add_history(beat_series);
+        step = turn;
+        rerender();
     }
 
     // Перемещение фигуры (через координаты)
     void move_piece(const POS_T i, const POS_T j, const POS_T i2, const POS_T j2, const int beat_series = 0)
     {
-        if (mtx[i2][j2])
-            throw runtime_error("final position is not empty, can't move");
-        if (!mtx[i][j])
-            throw runtime_error("begin position is empty, can't move");
-
-        // превращение в дамку
-        if ((mtx[i][j] == 1 && i2 == 0) || (mtx[i][j] == 2 && i2 == 7))
-            mtx[i][j] += 2;
-
-        mtx[i2][j2] = mtx[i][j];
-        drop_piece(i, j);
-        add_history(beat_series);
+        move_piece(move_pos(i, j, i2, j2), beat_series);
     }
 
     // Удаление фигуры с клетки
@@ -188,6 +202,48 @@ public:
         clear_active();
     }
 
+    // Ходы партии, восстановленные по истории состояний (после отката — без отменённых ходов).
+    // Шаг серии взятий (серия > 1) дописывается к предыдущему ходу
+    vector<vector<move_pos>> history_turns() const
+    {
+        vector<vector<move_pos>> turns;
+        for (size_t i = 1; i < history_mtx.size(); ++i)
+        {
+            const auto& before = history_mtx[i - 1];
+            const auto& after = history_mtx[i];
+            move_pos turn(-1, -1, -1, -1);
+            for (POS_T x = 0; x < 8; ++x)
+                for (POS_T y = 0; y < 8; ++y)
+                    if (!before[x][y] && after[x][y])
+                    {
+                        turn.x2 = x;
+                        turn.y2 = y;
+                    }
+            if (turn.x2 == -1)
+                continue;
+            for (POS_T x = 0; x < 8; ++x)
+                for (POS_T y = 0; y < 8; ++y)
+                    if (before[x][y] && !after[x][y])
+                    {
+                        if (before[x][y] % 2 == after[turn.x2][turn.y2] % 2)
+                        {
+                            turn.x = x;
+                            turn.y = y;
+                        }
+                        else
+                        {
+                            turn.xb = x;
+                            turn.yb = y;
+                        }
+                    }
+            if (history_beat_series[i] > 1 && !turns.empty())
+                turns.back().push_back(turn);
+            else
+                turns.push_back({ turn });
+        }
+        return turns;
+    }
+
     // Показ финального результата
     void show_final(const int res)
     {
@@ -195,25 +251,103 @@ public:
         rerender();
     }
 
-    // Обновление размеров окна
-    void reset_window_size()
+    // Поток игры: ожидание следующего события окна (его получает главный поток в run)
+    SDL_Event wait_event()
     {
-        SDL_GetRendererOutputSize(ren, &W, &H);
-        rerender();
+        unique_lock<mutex> lock(events_mtx);
+        events_cv.wait(lock, [&] { return !events.empty(); });
+        SDL_Event event = events.front();
+        events.pop_front();
+        return event;
+    }
+
+    // Цикл главного потока: события окна передаются потоку игры, кадры от него показываются по очереди
+    // с анимацией ходов, с частотой обновления экрана (vsync); неизменная картинка не перерисовывается.
+    // Возвращается, когда поток игры выставит finished
+    void run(const atomic<bool>& finished)
+    {
+        TRACE_SCOPE("Board::run");
+        deque<Frame> pending; // полученные, но ещё не показанные кадры
+        Frame shown, prev;    // показываемый кадр и предыдущий (откуда идёт анимация)
+        bool has_frame = false, animating = false, dirty = false;
+        uint64_t last_seq = 0;
+        double anim_ms = 0;
+        auto anim_start = chrono::steady_clock::now();
+        int w = 0, h = 0;
+        auto accept = [&](const Frame& frame) {
+            if (frame.seq > last_seq) // кадр старее уже полученного (пришёл после ящика) не нужен
+            {
+                last_seq = frame.seq;
+                pending.push_back(frame);
+            }
+        };
+
+        while (!finished)
+        {
+            pump_events();
+            Frame frame;
+            while (frames.pop(frame))
+                accept(frame);
+            if (Frame* last = overflow.exchange(nullptr, memory_order_acq_rel))
+            {
+                accept(*last);
+                delete last;
+            }
+
+            auto now = chrono::steady_clock::now();
+            double t = animating ? chrono::duration<double, milli>(now - anim_start).count() / anim_ms : 1;
+            if (animating && t >= 1)
+            {
+                animating = false;
+                dirty = true;
+            }
+            if (!animating && !pending.empty())
+            {
+                prev = shown;
+                shown = pending.front();
+                pending.pop_front();
+                const move_pos& st = shown.step;
+                // при большом отставании кадры показываются без анимации, при небольшом — анимация короче
+                if (has_frame && st.x != -1 && move_ms > 0 && pending.size() < 32)
+                {
+                    const int cells = abs(st.x2 - st.x);
+                    anim_ms = move_ms * (1 + 0.25 * (cells - 1)) / (1 + pending.size());
+                    anim_start = now;
+                    animating = true;
+                    t = 0;
+                }
+                has_frame = true;
+                dirty = true;
+            }
+
+            int out_w = 0, out_h = 0;
+            SDL_GetRendererOutputSize(ren, &out_w, &out_h);
+            if (out_w != w || out_h != h)
+            {
+                w = out_w;
+                h = out_h;
+                dirty = true;
+            }
+            if (!has_frame || (!animating && !dirty))
+            {
+                SDL_Delay(2); // ждём новых кадров и событий
+                continue;
+            }
+            const auto frame_start = chrono::steady_clock::now();
+            draw(shown, prev, animating ? t * t * (3 - 2 * t) : 1, w, h); // плавный разгон и торможение
+            dirty = false;
+            if (!vsync) // без vsync держим примерно 60 кадров в секунду
+                this_thread::sleep_until(frame_start + chrono::microseconds(16667));
+        }
     }
 
     // Завершение работы SDL
     void quit()
     {
-        SDL_DestroyTexture(board);
-        SDL_DestroyTexture(w_piece);
-        SDL_DestroyTexture(b_piece);
-        SDL_DestroyTexture(w_queen);
-        SDL_DestroyTexture(b_queen);
-        SDL_DestroyTexture(back);
-        SDL_DestroyTexture(replay);
-        SDL_DestroyRenderer(ren);
+        free_textures();
+        delete overflow.exchange(nullptr);
         SDL_DestroyWindow(win);
+        win = nullptr;
         SDL_Quit();
     }
 
@@ -224,6 +358,17 @@ public:
     }
 
 private:
+    // Снимок состояния доски для главного потока
+    struct Frame
+    {
+        uint64_t seq = 0; // номер кадра
+        POS_T mtx[8][8] = {};
+        bool highlighted[8][8] = {};
+        int active_x = -1, active_y = -1;
+        int game_results = -1;
+        move_pos step = move_pos(-1, -1, -1, -1); // ход, которым получен кадр (его анимирует главный поток)
+    };
+
     // Добавление состояния в историю
     void add_history(const int beat_series = 0)
     {
@@ -246,34 +391,113 @@ private:
         add_history();
     }
 
-    // Полная перерисовка окна
+    // Отправка текущего состояния главному потоку (вызывается после каждого изменения, не ждёт отрисовки)
     void rerender()
     {
+        TRACE_SCOPE("Board::rerender");
+        Frame frame;
+        frame.seq = ++frame_seq;
+        for (POS_T i = 0; i < 8; ++i)
+            for (POS_T j = 0; j < 8; ++j)
+            {
+                frame.mtx[i][j] = mtx[i][j];
+                frame.highlighted[i][j] = is_highlighted_[i][j];
+            }
+        frame.active_x = active_x;
+        frame.active_y = active_y;
+        frame.game_results = game_results;
+        frame.step = step;
+        step = move_pos(-1, -1, -1, -1);
+        Latency_probe::on_frame(frame.seq);
+        if (!ren)
+            return;
+
+        // очередь переполнена (главный поток не успевает) — последний кадр кладётся в ящик overflow,
+        // более ранний кадр из ящика теряется
+        if (!overflow.load(memory_order_acquire) && frames.push(frame))
+            return;
+        delete overflow.exchange(new Frame(frame), memory_order_acq_rel);
+    }
+
+    // Главный поток: события SDL передаются потоку игры; размер окна и F12 обрабатываются здесь
+    void pump_events()
+    {
+        SDL_Event event;
+        bool received = false;
+        while (SDL_PollEvent(&event))
+        {
+            if (event.type == SDL_WINDOWEVENT && event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED)
+            {
+                update_window_size();
+                continue;
+            }
+            if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F12)
+            {
+                if (Trace::is_enabled())
+                    Trace::dump(); // трассировка сохраняется по F12
+                continue;
+            }
+            lock_guard<mutex> lock(events_mtx);
+            events.push_back(event);
+            received = true;
+        }
+        if (received)
+            events_cv.notify_one();
+    }
+
+    void update_window_size()
+    {
+        int w = 0, h = 0;
+        SDL_GetWindowSize(win, &w, &h);
+        W = w;
+        H = h;
+    }
+
+    // Отрисовка кадра; moved — доля пройденного пути фигуры, которая ходит в этом кадре (1 — ход закончен)
+    void draw(const Frame& frame, const Frame& prev, const double moved, const int W, const int H)
+    {
+        TRACE_SCOPE("Board::draw");
         SDL_RenderClear(ren);
         SDL_RenderCopy(ren, board, NULL, NULL);
 
+        const move_pos& st = frame.step;
+        const bool is_moving = (st.x != -1 && moved < 1);
+        auto piece_texture = [&](const POS_T piece) {
+            if (piece == 1)
+                return w_piece;   // белая шашка
+            if (piece == 2)
+                return b_piece;   // чёрная шашка
+            if (piece == 3)
+                return w_queen;   // белая дамка
+            return b_queen;       // чёрная дамка
+        };
+        auto draw_piece = [&](const POS_T piece, const double i, const double j) {
+            SDL_Rect rect{ int(W * (j + 1) / 10) + W / 120, int(H * (i + 1) / 10) + H / 120, W / 12, H / 12 };
+            SDL_RenderCopy(ren, piece_texture(piece), NULL, &rect);
+        };
+
         // отрисовка шашек
         for (POS_T i = 0; i < 8; ++i)
         {
             for (POS_T j = 0; j < 8; ++j)
             {
-                if (!mtx[i][j]) continue;
-                int wpos = W * (j + 1) / 10 + W / 120;
-                int hpos = H * (i + 1) / 10 + H / 120;
-                SDL_Rect rect{ wpos, hpos, W / 12, H / 12 };
-
-                SDL_Texture* piece_texture;
-                if (mtx[i][j] == 1)
-                    piece_texture = w_piece;   // белая шашка
-                else if (mtx[i][j] == 2)
-                    piece_texture = b_piece;   // чёрная шашка
-                else if (mtx[i][j] == 3)
-                    piece_texture = w_queen;   // белая дамка
-                else
-                    piece_texture = b_queen;   // чёрная дамка
-
-                SDL_RenderCopy(ren, piece_texture, NULL, &rect);
+                if (!frame.mtx[i][j] || (is_moving && i == st.x2 && j == st.y2))
+                    continue;
+                draw_piece(frame.mtx[i][j], i, j);
+            }
+        }
+        if (is_moving)
+        {
+            // побитая фигура постепенно исчезает, ходящая (ещё без превращения в дамку) движется
+            if (st.xb != -1 && prev.mtx[st.xb][st.yb])
+            {
+                SDL_Texture* captured = piece_texture(prev.mtx[st.xb][st.yb]);
+                SDL_SetTextureAlphaMod(captured, Uint8(255 * (1 - moved)));
+                draw_piece(prev.mtx[st.xb][st.yb], st.xb, st.yb);
+                SDL_SetTextureAlphaMod(captured, 255);
             }
+            const POS_T piece = prev.mtx[st.x][st.y] ? prev.mtx[st.x][st.y] : frame.mtx[st.x2][st.y2];
+            draw_piece(piece, st.x + (st.x2 - st.x) * moved, st.y + (st.y2 - st.y) * moved);
         }
 
         // Подсветка возможных ходов (зелёные рамки)
@@ -284,7 +508,7 @@ private:
         {
             for (POS_T j = 0; j < 8; ++j)
             {
-                if (!is_highlighted_[i][j])
+                if (!frame.highlighted[i][j])
                     continue;
                 SDL_Rect cell{ int(W * (j + 1) / 10 / scale),
                                int(H * (i + 1) / 10 / scale),
@@ -295,11 +519,11 @@ private:
         }
 
         // Подсветка активной клетки (красная рамка)
-        if (active_x != -1)
+        if (frame.active_x != -1)
         {
             SDL_SetRenderDrawColor(ren, 255, 0, 0, 0);
-            SDL_Rect active_cell{ int(W * (active_y + 1) / 10 / scale),
-                                  int(H * (active_x + 1) / 10 / scale),
+            SDL_Rect active_cell{ int(W * (frame.active_y + 1) / 10 / scale),
+                                  int(H * (frame.active_x + 1) / 10 / scale),
                                   int(W / 10 / scale),
                                   int(H / 10 / scale) };
             SDL_RenderDrawRect(ren, &active_cell);
@@ -314,33 +538,48 @@ private:
         SDL_Rect replay_rect{ W * 109 / 120, H / 40, W / 15, H / 15 };
         SDL_RenderCopy(ren, replay, NULL, &replay_rect);
 
-        // Отрисовка результата игры (ничья, победа белых или чёрных)
-        if (game_results != -1)
+        // Отрисовка результата игры (ничья, победа белых или чёрных) — после анимации последнего хода
+        if (frame.game_results != -1 && !is_moving)
         {
-            string result_path = draw_path; // по умолчанию ничья
-            if (game_results == 1)
-                result_path = white_path;   // победа белых
-            else if (game_results == 2)
-                result_path = black_path;   // победа чёрных
-
-            SDL_Texture* result_texture = IMG_LoadTexture(ren, result_path.c_str());
-            if (result_texture == nullptr)
-            {
-                print_exception("IMG_LoadTexture can't load game result picture from " + result_path);
-                return;
-            }
             SDL_Rect res_rect{ W / 5, H * 3 / 10, W * 3 / 5, H * 2 / 5 };
-            SDL_RenderCopy(ren, result_texture, NULL, &res_rect);
-            SDL_DestroyTexture(result_texture);
+            SDL_RenderCopy(ren, results[frame.game_results % 3], NULL, &res_rect);
         }
 
-        // Завершаем отрисовку кадра
+        // Завершаем отрисовку кадра (с vsync ждёт обновления экрана)
+        TRACE_SCOPE("SDL_RenderPresent");
         SDL_RenderPresent(ren);
+        Latency_probe::on_present(frame.seq);
+    }
 
-        // Для macOS: задержка и обработка события окна
-        SDL_Delay(10);
-        SDL_Event windowEvent;
-        SDL_PollEvent(&windowEvent);
+    // Загрузка текстур
+    bool load_textures()
+    {
+        TRACE_SCOPE("Board::load_textures");
+        board = IMG_LoadTexture(ren, board_path.c_str());
+        w_piece = IMG_LoadTexture(ren, piece_white_path.c_str());
+        b_piece = IMG_LoadTexture(ren, piece_black_path.c_str());
+        w_queen = IMG_LoadTexture(ren, queen_white_path.c_str());
+        b_queen = IMG_LoadTexture(ren, queen_black_path.c_str());
+        back = IMG_LoadTexture(ren, back_path.c_str());
+        replay = IMG_LoadTexture(ren, replay_path.c_str());
+        results[0] = IMG_LoadTexture(ren, draw_path.c_str());
+        results[1] = IMG_LoadTexture(ren, white_path.c_str());
+        results[2] = IMG_LoadTexture(ren, black_path.c_str());
+        return board && w_piece && b_piece && w_queen && b_queen && back && replay && results[0] && results[1] &&
+               results[2];
+    }
+
+    void free_textures()
+    {
+        for (SDL_Texture* texture : { board, w_piece, b_piece, w_queen, b_queen, back, replay, results[0], results[1],
+                 results[2] })
+            if (texture)
+                SDL_DestroyTexture(texture);
+        board = w_piece = b_piece = w_queen = b_queen = back = replay = nullptr;
+        results[0] = results[1] = results[2] = nullptr;
+        if (ren)
+            SDL_DestroyRenderer(ren);
+        ren = nullptr;
     }
 
     // Логирование ошибок в файл log.txt
@@ -362,6 +601,7 @@ private:
     SDL_Texture* b_queen = nullptr;
     SDL_Texture* back = nullptr;
     SDL_Texture* replay = nullptr;
+    SDL_Texture* results[3] = { nullptr, nullptr, nullptr }; // ничья, победа белых, победа чёрных
 
     // Пути к файлам текстур
     const string textures_path = project_path + "Textures/";
@@ -391,4 +631,17 @@ private:
 
     // История серий взятий (для отката ходов)
     vector<int> history_beat_series;
+
+    // Отрисовка
+    int move_ms = 150;             // длительность анимации хода
+    move_pos step = move_pos(-1, -1, -1, -1); // ход, который попадёт в следующий кадр
+    uint64_t frame_seq = 0;
+    Spsc_queue<Frame, 64> frames;  // кадры для главного потока
+    atomic<Frame*> overflow{ nullptr }; // последний кадр, не поместившийся в очередь
+    bool vsync = false;            // SDL_RenderPresent ждёт обновления экрана
+
+    // События окна для потока игры
+    deque<SDL_Event> events;
+    mutex events_mtx;
+    condition_variable events_cv;
 };
@@ -1,35 +1,287 @@
 #pragma once
+#include <atomic>                  // флаг изменения файла (выставляет поток слежения)
+#include <filesystem>              // время изменения файла (слежение без inotify)
 #include <fstream>                 // для работы с файловыми потоками (чтение settings.json)
+#include <stdexcept>
+#include <string>
+#include <thread>                  // поток слежения за файлом
 #include <nlohmann/json.hpp>       // библиотека для работы с JSON
 using json = nlohmann::json;       // упрощаем обращение: теперь можно писать json вместо nlohmann::json
 
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
 #include "../Models/Project_path.h" // заголовок, где хранится путь к файлам проекта (например, project_path)
+#include "../Models/Settings.h"     // типизированные настройки
 
-// Класс Config отвечает за загрузку и хранение конфигурации игры из файла settings.json
+// Класс Config загружает настройки игры из файла settings.json в структуру Settings.
+// Файл разбирается и проверяется один раз, дальше игра и поиск читают готовые поля (без поиска по JSON).
+// Настройки заменяются только целиком: если в изменённом файле ошибка, остаются прежние.
+// Изменения файла можно применять на ходу: watch() следит за файлом (на Linux — inotify), poll()
+// между ходами перечитывает его, если он менялся. Настройки меняются только в потоке, который вызывает poll().
 class Config
 {
 public:
-    // Конструктор: при создании объекта Config сразу загружает настройки из файла
+    // Конструктор: при создании объекта Config сразу загружает настройки из файла.
+    // Если файл не читается или в нём ошибка — исключение runtime_error с описанием
     Config()
     {
-        reload();
+        std::string error;
+        if (!load(current, error))
+            throw std::runtime_error("settings.json: " + error);
     }
 
-    // Метод reload() перечитывает файл settings.json и обновляет объект config
-    void reload()
+    Config(const Config&) = delete;
+    Config& operator=(const Config&) = delete;
+
+    ~Config()
     {
-        std::ifstream fin(project_path + "settings.json"); // открываем файл настроек
-        fin >> config;                                     // читаем JSON в объект config
-        fin.close();                                       // закрываем файл
+        stop_watch();
+    }
+
+    // Текущие настройки
+    const Settings& settings() const
+    {
+        return current;
     }
 
-    // Перегруженный оператор () позволяет удобно получать доступ к настройкам
-    // Например: config("WindowSize", "Width") вернёт значение ширины окна
-    auto operator()(const string& setting_dir, const string& setting_name) const
+    // Метод reload() перечитывает файл settings.json. При ошибке настройки не меняются,
+    // причина пишется в log.txt. Возвращает true, если настройки обновлены
+    bool reload()
     {
-        return config[setting_dir][setting_name];
+        Settings next;
+        std::string error;
+        if (!load(next, error))
+        {
+            std::ofstream fout(project_path + "log.txt", std::ios_base::app);
+            fout << "Error: settings.json is not applied: " << error << "\n";
+            return false;
+        }
+        current = std::move(next);
+        return true;
+    }
+
+    // Начать слежение за settings.json
+    void watch()
+    {
+        if (watching)
+            return;
+        watching = true;
+#ifdef __linux__
+        // следим за каталогом: редакторы часто сохраняют файл через новый файл и переименование
+        watch_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        const std::string dir = project_path.empty() ? std::string(".") : project_path;
+        if (watch_fd >= 0 && inotify_add_watch(watch_fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) >= 0)
+        {
+            watch_stop = false;
+            watcher = std::thread(&Config::watch_loop, this);
+            return;
+        }
+        if (watch_fd >= 0)
+            ::close(watch_fd);
+        watch_fd = -1; // inotify недоступен — сравниваем время изменения, как на других системах
+#endif
+        std::error_code ec;
+        last_write = std::filesystem::last_write_time(project_path + "settings.json", ec);
+    }
+
+    // Вызывается между ходами: если settings.json изменился с прошлого раза, перечитывает его.
+    // Возвращает true, если настройки обновлены
+    bool poll()
+    {
+        if (!watching)
+            return false;
+        bool is_changed = false;
+#ifdef __linux__
+        if (watch_fd >= 0)
+            is_changed = changed.exchange(false);
+        else
+#endif
+        {
+            std::error_code ec;
+            const auto time = std::filesystem::last_write_time(project_path + "settings.json", ec);
+            is_changed = (!ec && time != last_write);
+            if (is_changed)
+                last_write = time;
+        }
+        return is_changed && reload();
     }
 
 private:
-    json config; // объект, в котором хранится вся структура настроек из settings.json
+    // Чтение и проверка settings.json; отсутствующие ключи берутся из значений по умолчанию
+    static bool load(Settings& s, std::string& error)
+    {
+        std::ifstream fin(project_path + "settings.json"); // открываем файл настроек
+        if (!fin)
+        {
+            error = "can't open " + project_path + "settings.json";
+            return false;
+        }
+        json config;
+        try
+        {
+            config = json::parse(fin, nullptr, true, true); // комментарии // допускаются
+        }
+        catch (const json::exception& e)
+        {
+            error = e.what();
+            return false;
+        }
+
+        read(config, "WindowSize", "Width", s.window.width, error);
+        read(config, "WindowSize", "Hight", s.window.height, error);
+        read(config, "WindowSize", "MoveAnimationMS", s.window.move_ms, error);
+
+        auto& bot = s.bot;
+        read(config, "Bot", "IsWhiteBot", bot.is_bot[0], error);
+        read(config, "Bot", "IsBlackBot", bot.is_bot[1], error);
+        read(config, "Bot", "WhiteBotLevel", bot.level[0], error);
+        read(config, "Bot", "BlackBotLevel", bot.level[1], error);
+        std::string level_type = "Depth", optimization = "O1";
+        read(config, "Bot", "LevelType", level_type, error);
+        read(config, "Bot", "LevelNodes", bot.level_nodes, error);
+        read(config, "Bot", "BotScoringType", bot.scoring_type, error);
+        read(config, "Bot", "NNWeightsPath", bot.nn_weights_path, error);
+        read(config, "Bot", "EvalParamsPath", bot.eval_params_path, error);
+        read(config, "Bot", "GameTimeMS", bot.game_time_ms, error);
+        read(config, "Bot", "IncrementMS", bot.increment_ms, error);
+        read(config, "Bot", "BotDelayMS", bot.delay_ms, error);
+        read(config, "Bot", "NoRandom", bot.no_random, error);
+        read(config, "Bot", "TTSizeMB", bot.tt_size_mb, error);
+        read(config, "Bot", "PersistentTTPath", bot.persistent_tt_path, error);
+        read(config, "Bot", "PersistentTTSizeMB", bot.persistent_tt_size_mb, error);
+        read(config, "Bot", "PersistentTTMinDepth", bot.persistent_tt_min_depth, error);
+        read(config, "Bot", "SolverMaxPieces", bot.solver_max_pieces, error);
+        read(config, "Bot", "SolverNodes", bot.solver_nodes, error);
+        read(config, "Bot", "SolverTableMB", bot.solver_table_mb, error);
+        read(config, "Bot", "Optimization", optimization, error);
+        std::string engine[2] = { "AlphaBeta", "AlphaBeta" }, mcts_leaf = "Eval";
+        read(config, "Bot", "WhiteBotEngine", engine[0], error);
+        read(config, "Bot", "BlackBotEngine", engine[1], error);
+        read(config, "Bot", "MctsTimeMS", bot.mcts_time_ms, error);
+        read(config, "Bot", "MctsThreads", bot.mcts_threads, error);
+        read(config, "Bot", "MctsMemoryMB", bot.mcts_memory_mb, error);
+        read(config, "Bot", "MctsLeaf", mcts_leaf, error);
+        read(config, "Bot", "MctsExploration", bot.mcts_exploration, error);
+
+        read(config, "Game", "MaxNumTurns", s.game.max_turns, error);
+        read(config, "Game", "DrawRepetitions", s.game.draw_repetitions, error);
+        read(config, "Game", "DrawNoProgressTurns", s.game.draw_no_progress, error);
+        read(config, "Game", "WatchSettings", s.game.watch_settings, error);
+        read(config, "Hint", "Lines", s.hint.lines, error);
+        read(config, "Hint", "TimeMS", s.hint.time_ms, error);
+        read(config, "Log", "SearchLog", s.log.search_log, error);
+        read(config, "Log", "GameArchive", s.log.game_archive, error);
+        read(config, "Log", "SearchTree", s.log.search_tree, error);
+        read(config, "Log", "SearchTreeLevels", s.log.search_tree_levels, error);
+        read(config, "Log", "SearchTreeSampleLevel", s.log.search_tree_sample_level, error);
+        read(config, "Log", "SearchTreeSample", s.log.search_tree_sample, error);
+        read(config, "Trace", "Enabled", s.trace.enabled, error);
+        read(config, "Trace", "Path", s.trace.path, error);
+        if (!error.empty())
+            return false;
+
+        // значения перечислений и допустимые диапазоны
+        if (level_type != "Depth" && level_type != "Nodes")
+            error = "Bot/LevelType must be \"Depth\" or \"Nodes\"";
+        bot.level_type = (level_type == "Nodes" ? Level_type::NODES : Level_type::DEPTH);
+        if (bot.scoring_type != "NumberOnly" && bot.scoring_type != "NumberAndPotential" && bot.scoring_type != "NN")
+            error = "Bot/BotScoringType must be \"NumberOnly\", \"NumberAndPotential\" or \"NN\"";
+        if (optimization.size() < 2 || optimization[0] != 'O' ||
+            optimization.find_first_not_of("0123456789", 1) != std::string::npos)
+            error = "Bot/Optimization must be \"O<number>\"";
+        else
+            bot.optimization = std::stoi(optimization.substr(1));
+        for (int color = 0; color < 2; ++color)
+        {
+            if (engine[color] != "AlphaBeta" && engine[color] != "MCTS")
+                error = "Bot/WhiteBotEngine and Bot/BlackBotEngine must be \"AlphaBeta\" or \"MCTS\"";
+            bot.engine[color] = (engine[color] == "MCTS" ? Engine_type::MCTS : Engine_type::ALPHA_BETA);
+        }
+        if (mcts_leaf != "Eval" && mcts_leaf != "Playout")
+            error = "Bot/MctsLeaf must be \"Eval\" or \"Playout\"";
+        bot.mcts_playouts = (mcts_leaf == "Playout");
+        if (bot.mcts_time_ms <= 0 || bot.mcts_threads < 0 || bot.mcts_memory_mb <= 0 || bot.mcts_exploration <= 0)
+            error = "Bot/MctsTimeMS, MctsMemoryMB and MctsExploration must be > 0, MctsThreads >= 0";
+        if (bot.level[0] < 0 || bot.level[1] < 0 || bot.level_nodes <= 0)
+            error = "bot levels must be >= 0 and Bot/LevelNodes > 0";
+        if (bot.tt_size_mb < 0 || bot.persistent_tt_size_mb < 0 || bot.solver_table_mb < 0 || bot.delay_ms < 0 ||
+            bot.game_time_ms < 0 || bot.increment_ms < 0 || bot.solver_max_pieces < 0 || bot.solver_nodes < 0)
+            error = "Bot sizes, times and solver limits must be >= 0";
+        if (s.game.max_turns <= 0 || s.game.draw_repetitions < 0 || s.game.draw_no_progress < 0)
+            error = "Game/MaxNumTurns must be > 0, draw rules >= 0";
+        if (s.window.move_ms < 0)
+            error = "WindowSize/MoveAnimationMS must be >= 0";
+        if (s.hint.lines < 1 || s.hint.time_ms < 0)
+            error = "Hint/Lines must be > 0, Hint/TimeMS >= 0";
+        if (s.log.search_tree_levels < 1 || s.log.search_tree_levels > 250 || s.log.search_tree_sample_level < 1 ||
+            s.log.search_tree_sample_level > 250 || s.log.search_tree_sample < 1)
+            error = "Log/SearchTreeLevels and SearchTreeSampleLevel must be 1..250, SearchTreeSample > 0";
+        return error.empty();
+    }
+
+    // Значение настройки setting_dir/setting_name, если оно есть в файле
+    template <class T>
+    static void read(const json& config, const char* setting_dir, const char* setting_name, T& value,
+        std::string& error)
+    {
+        if (!error.empty() || !config.contains(setting_dir) || !config[setting_dir].contains(setting_name))
+            return;
+        try
+        {
+            value = config[setting_dir][setting_name].get<T>();
+        }
+        catch (const json::exception&)
+        {
+            error = std::string(setting_dir) + "/" + setting_name + " has a wrong type";
+        }
+    }
+
+#ifdef __linux__
+    // Поток слежения: события каталога, относящиеся к settings.json, выставляют флаг changed
+    void watch_loop()
+    {
+        alignas(inotify_event) char buf[4096];
+        while (!watch_stop)
+        {
+            pollfd pfd = { watch_fd, POLLIN, 0 };
+            if (::poll(&pfd, 1, 200) <= 0)
+                continue;
+            const ssize_t len = ::read(watch_fd, buf, sizeof(buf));
+            for (ssize_t pos = 0; pos < len;)
+            {
+                const auto* event = reinterpret_cast<const inotify_event*>(buf + pos);
+                if (event->len && std::string(event->name) == "settings.json")
+                    changed = true;
+                pos += sizeof(inotify_event) + event->len;
+            }
+        }
+    }
+#endif
+
+    void stop_watch()
+    {
+#ifdef __linux__
+        watch_stop = true;
+        if (watcher.joinable())
+            watcher.join();
+        if (watch_fd >= 0)
+            ::close(watch_fd);
+        watch_fd = -1;
+#endif
+        watching = false;
+    }
+
+    Settings current; // текущие настройки
+    bool watching = false;
+    std::filesystem::file_time_type last_write; // время изменения файла при прошлой проверке (без inotify)
+#ifdef __linux__
+    int watch_fd = -1;
+    std::thread watcher;
+    std::atomic<bool> watch_stop{ false };
+    std::atomic<bool> changed{ false };
+#endif
 };
@@ -1,61 +1,124 @@
-Ы#pragma once
+#pragma once
+#include <atomic>   // флаг остановки фонового поиска подсказки
 #include <chrono>   // для измерения времени игры и ходов
+#include <memory>   // Logic подсказки создаётся при первом запросе
 #include <thread>   // для задержек (имитация времени раздумий бота)
 
+#include "../Models/Fen.h"          // запись ходов в журнале подсказок
 #include "../Models/Project_path.h" // путь к ресурсам проекта
 #include "Board.h"   // класс доски (отрисовка и хранение состояния)
 #include "Config.h"  // класс конфигурации (чтение настроек из settings.json)
+#include "Game_archive.h" // архив сыгранных партий
 #include "Hand.h"    // класс для обработки ввода игрока (мышь/клавиатура)
+#include "Latency_probe.h" // замер отклика игры (Tools/latency)
+#include "Logger.h"  // структурированный журнал (статистика поиска в формате JSON lines)
 #include "Logic.h"   // класс логики игры (генерация ходов, проверка правил)
+#include "Mcts.h"    // второй движок бота (поиск Монте-Карло по дереву)
+#include "Pn_solver.h" // решатель окончаний (доказательство выигрыша)
+#include "Position_history.h" // история позиций (ничья по повторению)
+#include "Time_manager.h" // распределение времени ботов на партию
+#include "Trace.h"   // трассировка этапов игры (формат Chrome trace)
 
 class Game
 {
 public:
     // Конструктор: инициализирует доску, руку игрока и логику
-    // Также очищает лог-файл (log.txt)
-    Game() : board(config("WindowSize", "Width"), config("WindowSize", "Hight")),
+    // Также очищает лог-файл (log.txt) и открывает журнал поиска (Log/SearchLog)
+    // Если включено Game/WatchSettings, изменения settings.json применяются между ходами
+    Game() : board(config.settings().window.width, config.settings().window.height, config.settings().window.move_ms),
         hand(&board),
-        logic(&board, &config)
+        logic(&config),
+        logger(log_path(config.settings().log.search_log))
     {
         ofstream fout(project_path + "log.txt", ios_base::trunc);
         fout.close();
+        Trace::set_enabled(config.settings().trace.enabled);
+        Trace::set_path(project_path + config.settings().trace.path);
+        const string& archive_path = config.settings().log.game_archive;
+        if (!archive_path.empty())
+            archive.open(project_path + archive_path); // не открылся — партии просто не сохраняются
+        if (config.settings().game.watch_settings)
+            config.watch();
+    }
+
+    // Деструктор: сохраняет трассировку, если она включена
+    ~Game()
+    {
+        stop_hint();
+        if (Trace::is_enabled())
+            Trace::dump();
     }
 
     // Основной метод: запуск партии в шашки
+    // Окно, события и отрисовка остаются в главном потоке (так требует SDL), партии и боты идут в потоке игры
     int play()
     {
+        if (board.start_draw())
+            return 1;
+        atomic<bool> finished{ false };
+        int res = 0;
+        thread game_thread([&] {
+            res = play_games();
+            finished = true;
+        });
+        board.run(finished);
+        game_thread.join();
+        return res;
+    }
+
+private:
+    // Партии до выхода из игры (поток игры)
+    int play_games()
+    {
+        TRACE_SCOPE("Game::play");
         auto start = chrono::steady_clock::now(); // время начала партии
 
         // Если это повтор (REPLAY), то перезапускаем логику и перерисовываем доску
         if (is_replay)
         {
-            logic = Logic(&board, &config);
+            stop_hint();
+            hint_logic.reset(); // таблица транспозиций подсказки — от прежнего Logic
             config.reload();
+            logic.close_persistent_tt(); // новый Logic с другой оценкой очистит файловую таблицу
+            logic = Logic(&config);
             board.redraw();
         }
-        else
-        {
-            board.start_draw(); // первый запуск отрисовки доски
-        }
         is_replay = false;
+        time_manager.new_game(config.settings().bot.game_time_ms, config.settings().bot.increment_ms);
 
         int turn_num = -1;        // номер текущего хода
         bool is_quit = false;     // флаг выхода из игры
-        const int Max_turns = config("Game", "MaxNumTurns"); // ограничение по количеству ходов
+        bool is_draw = false;     // ничья по повторению или по отсутствию прогресса
+        const Settings& settings = config.settings(); // поля читаются на каждом ходу: после poll() — новые значения
+        const int Max_turns = settings.game.max_turns; // ограничение по количеству ходов (на всю партию)
+        history.clear();
 
         // Основной цикл игры
         while (++turn_num < Max_turns)
         {
+            stop_hint(); // подсказка к прошлому ходу больше не нужна
+            if (config.poll()) // settings.json изменён — новые настройки с этого хода
+                apply_settings();
             beat_series = 0; // количество последовательных взятий
-            logic.find_turns(turn_num % 2); // генерируем возможные ходы для текущего игрока
+            logic.find_turns(turn_num % 2, board.get_board()); // генерируем возможные ходы для текущего игрока
             if (logic.turns.empty()) // если ходов нет — игра окончена
                 break;
 
-            // Устанавливаем глубину поиска для бота (уровень сложности)
-            logic.Max_depth = config("Bot", string((turn_num % 2) ? "Black" : "White") + string("BotLevel"));
+            // история позиций: после отката хода лишние записи отбрасываются
+            history.set(turn_num, board.get_board());
+            if ((settings.game.draw_repetitions && history.repetitions() >= settings.game.draw_repetitions) ||
+                (settings.game.draw_no_progress && history.no_progress() >= settings.game.draw_no_progress))
+            {
+                is_draw = true;
+                break;
+            }
+            logic.set_history(history.reversible_hashes());
+
+            // Устанавливаем уровень сложности бота (глубина поиска или бюджет узлов)
+            logic.set_level(settings.bot.level[turn_num % 2]);
 
             // Если ходит человек
-            if (!config("Bot", string("Is") + string((turn_num % 2) ? "Black" : "White") + string("Bot")))
+            if (!settings.bot.is_bot[turn_num % 2])
             {
                 auto resp = player_turn(turn_num % 2); // обработка хода игрока
                 if (resp == Response::QUIT) // выход из игры
@@ -71,7 +134,7 @@ public:
                 else if (resp == Response::BACK) // откат хода
                 {
                     // если бот играл предыдущим цветом и есть история ходов
-                    if (config("Bot", string("Is") + string((1 - turn_num % 2) ? "Black" : "White") + string("Bot")) &&
+                    if (settings.bot.is_bot[1 - turn_num % 2] &&
                         !beat_series && board.history_mtx.size() > 2)
                     {
                         board.rollback(); // откат последнего хода
@@ -86,79 +149,216 @@ public:
                 }
             }
             else
-                bot_turn(turn_num % 2); // если ходит бот
+                bot_turn(turn_num % 2, Max_turns - turn_num); // если ходит бот
         }
 
+        stop_hint();
+
         // Подсчёт времени партии
         auto end = chrono::steady_clock::now();
-        ofstream fout(project_path + "log.txt", ios_base::app);
-        fout << "Game time: "
-            << (int)chrono::duration<double, milli>(end - start).count()
-            << " millisec\n";
-        fout.close();
+        logger.write({ { "event", "game" },
+                       { "turns", turn_num },
+                       { "time_ms", (int)chrono::duration<double, milli>(end - start).count() } });
+        logger.flush();
 
         // Обработка завершения партии
         if (is_replay)
-            return play();
+            return play_games();
         if (is_quit)
             return 0;
 
         int res = 2; // результат: 0 — ничья, 1 — победа чёрных, 2 — победа белых
-        if (turn_num == Max_turns)
+        if (turn_num == Max_turns || is_draw)
         {
-            res = 0; // ничья по лимиту ходов
+            res = 0; // ничья по лимиту ходов, повторению или отсутствию прогресса
         }
         else if (turn_num % 2)
         {
             res = 1; // победа чёрных
         }
+        save_game(res);
         board.show_final(res); // показать финальный экран
+        Latency_probe::on_game_over();
 
         auto resp = hand.wait(); // ожидание действия игрока
         if (resp == Response::REPLAY)
         {
             is_replay = true;
-            return play(); // перезапуск
+            return play_games(); // перезапуск
         }
         return res;
     }
 
-private:
     // Ход бота
-    void bot_turn(const bool color)
+    // turns_left — сколько полуходов осталось до MaxNumTurns (для распределения времени)
+    void bot_turn(const bool color, const int turns_left)
     {
+        TRACE_SCOPE("Game::bot_turn");
         auto start = chrono::steady_clock::now();
+        Latency_probe::on_bot_turn();
 
-        auto delay_ms = config("Bot", "BotDelayMS"); // задержка перед ходом
+        const Bot_settings& bot = config.settings().bot;
+        auto delay_ms = bot.delay_ms;                // задержка перед ходом
         thread th(SDL_Delay, delay_ms);              // имитация "раздумий" бота
-        auto turns = logic.find_best_turns(color);   // поиск лучшего хода
-        th.join();
-
-        bool is_first = true;
-        // выполнение хода (или серии взятий)
-        for (auto turn : turns)
+        vector<move_pos> turns;                      // поиск лучшего хода
+        Pn_solver::Solution solution;                // решение окончания (если фигур мало)
+        if (bot.solver_max_pieces && Pn_solver::count_pieces(board.get_board()) <= bot.solver_max_pieces)
+        {
+            if (!solver)
+                solver = make_unique<Pn_solver>(logic, size_t(bot.solver_table_mb));
+            solution = solver->solve(board.get_board(), color, bot.solver_nodes);
+        }
+        if (solution.result == Pn_solver::WIN && !solution.line.empty()) // выигрыш доказан — ход из варианта
+            turns = solution.line[0];
+        else if (bot.engine[color] == Engine_type::MCTS) // поиск Монте-Карло: по времени на партию или MctsTimeMS
         {
-            if (!is_first)
+            if (!mcts)
+                mcts = make_unique<Mcts>(logic, bot);
+            if (time_manager.is_enabled())
             {
-                SDL_Delay(delay_ms);
+                auto limits = time_manager.start_move(color, turns_left);
+                turns = mcts->search(board.get_board(), color, limits,
+                    [this](const Search_info& info) { time_manager.on_iteration(info); });
             }
-            is_first = false;
+            else
+            {
+                Search_limits limits;
+                limits.time_ms = bot.mcts_time_ms;
+                turns = mcts->search(board.get_board(), color, limits);
+            }
+        }
+        else if (time_manager.is_enabled()) // по времени: итеративное углубление в пределах выделенного на ход
+        {
+            auto limits = time_manager.start_move(color, turns_left);
+            turns = logic.search(board.get_board(), color, limits,
+                [this](const Search_info& info) { time_manager.on_iteration(info); });
+        }
+        else
+            turns = logic.find_best_turns(board.get_board(), color);
+        {
+            TRACE_SCOPE("Game::bot_delay_wait");
+            th.join();
+        }
+        if (time_manager.is_enabled())
+            time_manager.end_move(color, chrono::duration_cast<chrono::milliseconds>(
+                                             chrono::steady_clock::now() - start).count());
+
+        // выполнение хода (или серии взятий); шаги серии по очереди анимирует главный поток
+        for (auto turn : turns)
+        {
             beat_series += (turn.xb != -1); // учёт серии взятий
             board.move_piece(turn, beat_series);
         }
 
-        // логируем время хода бота
+        // логируем время хода бота и статистику поиска
         auto end = chrono::steady_clock::now();
-        ofstream fout(project_path + "log.txt", ios_base::app);
-        fout << "Bot turn time: "
-            << (int)chrono::duration<double, milli>(end - start).count()
-            << " millisec\n";
-        fout.close();
+        auto record = (bot.engine[color] == Engine_type::MCTS && mcts ? Logger::to_json(mcts->get_stats())
+                                                                        : Logger::to_json(logic.get_stats()));
+        record["event"] = "bot_turn";
+        record["color"] = (color ? "black" : "white");
+        record["turn_time_ms"] = (int)chrono::duration<double, milli>(end - start).count();
+        if (time_manager.is_enabled())
+            record["time_left_ms"] = time_manager.get_remaining(color);
+        if (solution.nodes)
+            record["solver"] = { { "result", solution.result == Pn_solver::WIN      ? "win"
+                                             : solution.result == Pn_solver::NO_WIN ? "no_win"
+                                                                                    : "unknown" },
+                { "nodes", solution.nodes }, { "time_ms", solution.time_ms }, { "distance", solution.distance } };
+        logger.write(record);
+    }
+
+    // Запуск поиска подсказки в фоне: Hint/Lines лучших ходов за Hint/TimeMS. Отдельный Logic использует
+    // общую с ботом таблицу транспозиций. По окончании поток присылает SDL_USEREVENT (Response::HINT_READY).
+    void start_hint(const bool color)
+    {
+        stop_hint();
+        if (!hint_logic)
+        {
+            hint_logic = make_unique<Logic>(&config, false); // таблица общая с ботом
+            hint_logic->set_tt(logic.get_tt());
+        }
+        hint_logic->set_history(history.reversible_hashes());
+        hint_board = board.get_board();
+        hint_lines.clear();
+        hint_stop = false;
+        Search_limits limits;
+        limits.depth = 64;
+        limits.time_ms = config.settings().hint.time_ms;
+        limits.stop = &hint_stop;
+        const size_t count = config.settings().hint.lines;
+        hint_thread = thread([this, color, count, limits]() {
+            hint_lines = hint_logic->search_multipv(hint_board, color, count, limits);
+            SDL_Event event{};
+            event.type = SDL_USEREVENT;
+            SDL_PushEvent(&event);
+        });
+    }
+
+    // Остановка фонового поиска подсказки
+    void stop_hint()
+    {
+        hint_stop = true;
+        if (hint_thread.joinable())
+            hint_thread.join();
+    }
+
+    // Показ готовой подсказки: фигура лучшего хода выделяется, клетки хода подсвечиваются.
+    // Все найденные варианты пишутся в журнал поиска. Возвращает клетку фигуры ((-1, -1) — подсказка устарела)
+    pair<POS_T, POS_T> show_hint()
+    {
+        stop_hint();
+        if (hint_lines.empty() || hint_board != board.get_board())
+            return { -1, -1 };
+
+        json record = { { "event", "hint" }, { "depth", hint_logic->get_stats().depth } };
+        for (const auto& line : hint_lines)
+            record["lines"].push_back(
+                { { "move", move_to_string(line.turns) }, { "score", line.score }, { "pv", pv_to_string(line.pv) } });
+        logger.write(record);
+
+        const auto& best = hint_lines[0].turns;
+        vector<pair<POS_T, POS_T>> cells;
+        for (const auto& turn : best)
+            cells.emplace_back(turn.x2, turn.y2);
+        board.clear_highlight();
+        board.set_active(best[0].x, best[0].y);
+        board.highlight_cells(cells);
+        return { best[0].x, best[0].y };
+    }
+
+    // Применение перечитанного settings.json: настройки ботов (уровни, оценка, задержки, решатель) действуют
+    // с текущего хода; время на партию и правила ничьей — с новой партии; окно, журналы и размеры таблиц — после перезапуска
+    void apply_settings()
+    {
+        hint_logic.reset(); // создаётся заново с новыми настройками при следующей подсказке (до смены оценки
+                            // бота: открытая подсказкой файловая таблица не дала бы её очистить)
+        logic.apply_settings();
+        solver.reset();     // размер таблицы решателя мог измениться
+        mcts.reset();       // и настройки MCTS, и оценка, которой построено его дерево
+    }
+
+    // Запись законченной партии в архив (Log/GameArchive)
+    void save_game(const int res)
+    {
+        if (!archive.is_open())
+            return;
+        Game_record rec;
+        rec.turns = board.history_turns();
+        rec.result = (res == 0 ? RESULT_DRAW : res == 1 ? RESULT_BLACK_WIN : RESULT_WHITE_WIN);
+        archive.append(rec);
+        archive.flush(); // партий мало, каждая сразу на диске
+    }
+
+    // Путь к журналу поиска (пустая настройка — журнал выключен)
+    static string log_path(const string& name)
+    {
+        return name.empty() ? string() : project_path + name;
     }
 
     // Ход игрока
     Response player_turn(const bool color)
     {
+        TRACE_SCOPE("Game::player_turn");
         // Подсветка возможных фигур для хода
         vector<pair<POS_T, POS_T>> cells;
         for (auto turn : logic.turns)
@@ -166,6 +366,8 @@ private:
             cells.emplace_back(turn.x, turn.y);
         }
         board.highlight_cells(cells);
+        if (Latency_probe::is_enabled()) // сценарий Tools/latency ходит за игрока
+            Latency_probe::on_player_turn(board.get_board(), color, board.W, board.H);
 
         move_pos pos = { -1, -1, -1, -1 }; // выбранный ход
         POS_T x = -1, y = -1;            // координаты выбранной фигуры
@@ -174,6 +376,21 @@ private:
         while (true)
         {
             auto resp = hand.get_cell(); // ожидание клика игрока
+            if (get<0>(resp) == Response::HINT) // подсказка считается в фоне, игрок может ходить не дожидаясь
+            {
+                start_hint(color);
+                continue;
+            }
+            if (get<0>(resp) == Response::HINT_READY)
+            {
+                auto from = show_hint();
+                if (from.first != -1) // клик по подсвеченной клетке сразу делает подсказанный ход
+                {
+                    x = from.first;
+                    y = from.second;
+                }
+                continue;
+            }
             if (get<0>(resp) != Response::CELL)
                 return get<0>(resp); // если игрок нажал "выход" или "повтор"
 
@@ -240,7 +457,7 @@ private:
         beat_series = 1;
         while (true)
         {
-            logic.find_turns(pos.x2, pos.y2);
+            logic.find_turns(pos.x2, pos.y2, board.get_board());
             if (!logic.have_beats)
                 break;
 
@@ -255,6 +472,8 @@ private:
             while (true)
             {
                 auto resp = hand.get_cell(); // ждём клик игрока
+                if (get<0>(resp) == Response::HINT || get<0>(resp) == Response::HINT_READY)
+                    continue; // посреди серии взятий подсказка не нужна
                 if (get<0>(resp) != Response::CELL)
                     return get<0>(resp); // если игрок нажал "выход" или "повтор"
 
@@ -291,6 +510,17 @@ private:
       Board board;     // игровая доска (отрисовка и хранение состояния)
       Hand hand;       // обработка ввода игрока (мышь/клавиатура)
       Logic logic;     // логика игры (генерация ходов, проверка правил)
+      Logger logger;   // журнал статистики поиска (JSON lines)
+      Game_archive_writer archive; // архив сыгранных партий (Log/GameArchive)
+      Time_manager time_manager; // время ботов на партию (Bot/GameTimeMS)
+      Position_history history;  // позиции партии в начале каждого хода
+      unique_ptr<Pn_solver> solver;   // решатель окончаний бота (создаётся при первом окончании)
+      unique_ptr<Mcts> mcts;          // движок MCTS (создаётся при первом ходе бота с "MCTS")
+      unique_ptr<Logic> hint_logic;   // поиск подсказок (отдельно от бота, чтобы не трогать его состояние)
+      thread hint_thread;             // фоновый поиск подсказки
+      atomic<bool> hint_stop{ false }; // остановка поиска подсказки
+      vector<vector<POS_T>> hint_board; // позиция, для которой считается подсказка
+      vector<Search_line> hint_lines;   // найденные варианты (читаются после завершения потока)
       int beat_series; // количество последовательных взятий в текущем ходе
       bool is_replay = false; // флаг перезапуска партии
 };
@@ -0,0 +1,500 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <zlib.h>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "../Models/Game_record.h"
+
+// Архив партий: два файла, <path> с данными и <path>.idx с оглавлением.
+// Данные — блоки по ~32 КБ записей партий (Game_record::encode), каждый сжат deflate (zlib) отдельно,
+// поэтому для чтения одной партии распаковывается только её блок. Оглавление — записи фиксированного
+// размера (16 байт) по одной на партию: где лежит её блок, смещение внутри блока, длина и итог.
+// Партия N находится за O(1), длины и итоги просматриваются без распаковки.
+// Блок сначала дописывается в файл данных, потом его записи в оглавление: после сбоя в оглавлении
+// могут не оказаться последние партии, но оно никогда не ссылается на недописанные данные.
+struct Game_archive
+{
+    static const uint32_t VERSION = 1;
+    static const size_t BLOCK_BYTES = 1 << 15; // размер блока до сжатия
+
+    struct File_header
+    {
+        char magic[4];
+        uint32_t version;
+        uint64_t reserved[7]; // заголовок занимает 64 байта
+    };
+
+    struct Block_header
+    {
+        uint32_t raw_size;    // размер записей до сжатия
+        uint32_t packed_size; // размер сжатых данных после заголовка
+        uint32_t game_count;
+        uint32_t crc;         // CRC32 записей до сжатия
+    };
+
+    struct Index_entry
+    {
+        uint64_t block_offset; // смещение заголовка блока в файле данных
+        uint32_t raw_offset;   // смещение записи партии в распакованном блоке
+        uint16_t plies;        // число ходов
+        uint8_t result;        // Record_result
+        uint8_t flags;         // бит 0 — нестандартная начальная позиция
+    };
+
+    static constexpr const char* DATA_MAGIC = "CKGA";
+    static constexpr const char* INDEX_MAGIC = "CKGI";
+
+    static std::string index_path(const std::string& path)
+    {
+        return path + ".idx";
+    }
+
+    static File_header make_header(const char* magic)
+    {
+        File_header header = {};
+        memcpy(header.magic, magic, 4);
+        header.version = VERSION;
+        return header;
+    }
+
+    static bool check_header(const File_header& header, const char* magic)
+    {
+        return memcmp(header.magic, magic, 4) == 0 && header.version == VERSION;
+    }
+};
+
+static_assert(sizeof(Game_archive::File_header) == 64, "archive header must stay 64 bytes");
+static_assert(sizeof(Game_archive::Block_header) == 16, "block header must stay 16 bytes");
+static_assert(sizeof(Game_archive::Index_entry) == 16, "index entry must stay 16 bytes");
+
+// Дописывание партий в архив. append можно вызывать из многих потоков: запись партии копится в текущем блоке
+// под блокировкой, а сжатие заполненного блока идёт в потоке, который его заполнил, без блокировки.
+// Блоки попадают в файл строго в порядке номеров партий (очередь по билетам).
+// Писать в архив может только один процесс.
+class Game_archive_writer
+{
+public:
+    Game_archive_writer() = default;
+    Game_archive_writer(const Game_archive_writer&) = delete;
+    Game_archive_writer& operator=(const Game_archive_writer&) = delete;
+
+    ~Game_archive_writer()
+    {
+        close();
+    }
+
+    // Открытие архива для дописывания (создаётся, если его нет). Хвост, оставшийся после сбоя
+    // (блок без записей в оглавлении, неполная запись оглавления), отрезается. level — уровень сжатия zlib
+    bool open(const std::string& path, const int level = Z_DEFAULT_COMPRESSION)
+    {
+        close();
+        namespace fs = std::filesystem;
+        const std::string idx_path = Game_archive::index_path(path);
+        std::error_code ec;
+        uint64_t data_end = sizeof(Game_archive::File_header);
+        uint64_t count = 0;
+        if (fs::exists(path, ec) && fs::exists(idx_path, ec))
+        {
+            std::ifstream data_in(path, std::ios::binary), idx_in(idx_path, std::ios::binary);
+            Game_archive::File_header data_header{}, idx_header{};
+            data_in.read(reinterpret_cast<char*>(&data_header), sizeof(data_header));
+            idx_in.read(reinterpret_cast<char*>(&idx_header), sizeof(idx_header));
+            if (!data_in || !idx_in || !Game_archive::check_header(data_header, Game_archive::DATA_MAGIC) ||
+                !Game_archive::check_header(idx_header, Game_archive::INDEX_MAGIC))
+                return false; // чужой файл не перезаписываем
+            const uint64_t data_size = fs::file_size(path, ec);
+            count = (fs::file_size(idx_path, ec) - sizeof(idx_header)) / sizeof(Game_archive::Index_entry);
+            // последний блок, на который ссылается оглавление, должен быть дописан целиком
+            while (count)
+            {
+                Game_archive::Index_entry last{};
+                Game_archive::Block_header block{};
+                idx_in.seekg(std::streamoff(sizeof(idx_header) + (count - 1) * sizeof(last)));
+                idx_in.read(reinterpret_cast<char*>(&last), sizeof(last));
+                data_in.seekg(std::streamoff(last.block_offset));
+                data_in.read(reinterpret_cast<char*>(&block), sizeof(block));
+                data_end = last.block_offset + sizeof(block) + block.packed_size;
+                if (idx_in && data_in && data_end <= data_size)
+                    break;
+                data_in.clear();
+                idx_in.clear();
+                --count;
+                data_end = sizeof(Game_archive::File_header);
+            }
+            data_in.close();
+            idx_in.close();
+            fs::resize_file(path, data_end, ec);
+            fs::resize_file(idx_path, sizeof(idx_header) + count * sizeof(Game_archive::Index_entry), ec);
+            if (ec)
+                return false;
+        }
+        else
+        {
+            const auto data_header = Game_archive::make_header(Game_archive::DATA_MAGIC);
+            const auto idx_header = Game_archive::make_header(Game_archive::INDEX_MAGIC);
+            std::ofstream data_out(path, std::ios::binary | std::ios::trunc);
+            std::ofstream idx_out(idx_path, std::ios::binary | std::ios::trunc);
+            data_out.write(reinterpret_cast<const char*>(&data_header), sizeof(data_header));
+            idx_out.write(reinterpret_cast<const char*>(&idx_header), sizeof(idx_header));
+            if (!data_out || !idx_out)
+                return false;
+        }
+
+        data = fopen(path.c_str(), "ab");
+        index = fopen(idx_path.c_str(), "ab");
+        if (!data || !index)
+        {
+            close();
+            return false;
+        }
+        compression = level;
+        games = count;
+        data_size = data_end;
+        next_ticket = write_ticket = 0;
+        current = Block();
+        return true;
+    }
+
+    bool is_open() const
+    {
+        return data != nullptr;
+    }
+
+    // Число партий в архиве (вместе с ещё не записанными на диск)
+    uint64_t size()
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        return games;
+    }
+
+    // Добавление партии; возвращает её номер в архиве
+    uint64_t append(const Game_record& game)
+    {
+        std::vector<uint8_t> rec;
+        game.encode(rec);
+        Game_archive::Index_entry entry = {};
+        entry.plies = uint16_t(game.turns.size());
+        entry.result = uint8_t(game.result);
+        entry.flags = uint8_t(!game.is_standard_start());
+
+        Block full;
+        uint64_t number;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            entry.raw_offset = uint32_t(current.raw.size());
+            current.raw.insert(current.raw.end(), rec.begin(), rec.end());
+            current.entries.push_back(entry);
+            number = games++;
+            if (current.raw.size() >= Game_archive::BLOCK_BYTES)
+                full = take_block();
+        }
+        if (!full.entries.empty())
+            write_block(full);
+        return number;
+    }
+
+    // Запись неполного текущего блока; возвращается после того, как на диске все добавленные партии
+    void flush()
+    {
+        Block last;
+        uint64_t until;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (!current.entries.empty())
+                last = take_block();
+            until = next_ticket;
+        }
+        if (!last.entries.empty())
+            write_block(last);
+        std::unique_lock<std::mutex> lock(write_mtx);
+        written.wait(lock, [&]() { return write_ticket >= until; });
+    }
+
+    void close()
+    {
+        if (data)
+            flush();
+        if (data)
+            fclose(data);
+        if (index)
+            fclose(index);
+        data = index = nullptr;
+    }
+
+private:
+    struct Block
+    {
+        std::vector<uint8_t> raw;
+        std::vector<Game_archive::Index_entry> entries;
+        uint64_t ticket = 0;
+    };
+
+    // Вызывается под mtx
+    Block take_block()
+    {
+        Block block = std::move(current);
+        block.ticket = next_ticket++;
+        current = Block();
+        current.raw.reserve(Game_archive::BLOCK_BYTES + 1024);
+        return block;
+    }
+
+    // Сжатие блока и запись в его очередь
+    void write_block(Block& block)
+    {
+        uLongf packed_size = compressBound(uLong(block.raw.size()));
+        std::vector<uint8_t> packed(sizeof(Game_archive::Block_header) + packed_size);
+        compress2(packed.data() + sizeof(Game_archive::Block_header), &packed_size, block.raw.data(),
+            uLong(block.raw.size()), compression);
+        Game_archive::Block_header header;
+        header.raw_size = uint32_t(block.raw.size());
+        header.packed_size = uint32_t(packed_size);
+        header.game_count = uint32_t(block.entries.size());
+        header.crc = uint32_t(crc32(0L, block.raw.data(), uInt(block.raw.size())));
+        memcpy(packed.data(), &header, sizeof(header));
+
+        std::unique_lock<std::mutex> lock(write_mtx);
+        written.wait(lock, [&]() { return write_ticket == block.ticket; });
+        for (auto& entry : block.entries)
+            entry.block_offset = data_size;
+        fwrite(packed.data(), 1, sizeof(header) + packed_size, data);
+        fflush(data); // данные блока раньше его записей в оглавлении
+        fwrite(block.entries.data(), sizeof(Game_archive::Index_entry), block.entries.size(), index);
+        fflush(index);
+        data_size += sizeof(header) + packed_size;
+        ++write_ticket;
+        written.notify_all();
+    }
+
+    FILE* data = nullptr;
+    FILE* index = nullptr;
+    int compression = Z_DEFAULT_COMPRESSION;
+
+    std::mutex mtx; // текущий блок и нумерация партий
+    Block current;
+    uint64_t games = 0;
+    uint64_t next_ticket = 0;
+
+    std::mutex write_mtx; // порядок записи блоков в файлы
+    std::condition_variable written;
+    uint64_t write_ticket = 0;
+    uint64_t data_size = 0;
+};
+
+// Чтение архива через отображение файлов в память: произвольный доступ к партии N и последовательный проход.
+// Видны партии, записанные на момент открытия. Последний распакованный блок кэшируется, поэтому
+// последовательное чтение распаковывает каждый блок один раз. Один объект — для одного потока.
+class Game_archive_reader
+{
+public:
+    Game_archive_reader() = default;
+    Game_archive_reader(const Game_archive_reader&) = delete;
+    Game_archive_reader& operator=(const Game_archive_reader&) = delete;
+
+    ~Game_archive_reader()
+    {
+        close();
+    }
+
+    bool open(const std::string& path)
+    {
+        close();
+        if (!data.map(path) || !index.map(Game_archive::index_path(path)) ||
+            data.size < sizeof(Game_archive::File_header) || index.size < sizeof(Game_archive::File_header) ||
+            !Game_archive::check_header(*reinterpret_cast<const Game_archive::File_header*>(data.base),
+                Game_archive::DATA_MAGIC) ||
+            !Game_archive::check_header(*reinterpret_cast<const Game_archive::File_header*>(index.base),
+                Game_archive::INDEX_MAGIC))
+        {
+            close();
+            return false;
+        }
+        entries = reinterpret_cast<const Game_archive::Index_entry*>(index.base + sizeof(Game_archive::File_header));
+        count = (index.size - sizeof(Game_archive::File_header)) / sizeof(Game_archive::Index_entry);
+        while (count && !block_fits(entries[count - 1].block_offset)) // хвост, который дописывается сейчас
+            --count;
+        return true;
+    }
+
+    void close()
+    {
+        data.unmap();
+        index.unmap();
+        entries = nullptr;
+        count = 0;
+        cached_offset = UINT64_MAX;
+    }
+
+    uint64_t size() const
+    {
+        return count;
+    }
+
+    // Длина, итог и место партии без распаковки
+    const Game_archive::Index_entry& info(const uint64_t n) const
+    {
+        return entries[n];
+    }
+
+    // Размер файла данных (для статистики)
+    uint64_t data_bytes() const
+    {
+        return data.size;
+    }
+
+    // Чтение партии n; false — номер вне архива или повреждённый блок
+    bool read(const uint64_t n, Game_record& game)
+    {
+        if (n >= count)
+            return false;
+        const auto& entry = entries[n];
+        if (!load_block(entry.block_offset) || entry.raw_offset >= cache.size())
+            return false;
+        if (!game.decode(cache.data() + entry.raw_offset, cache.size() - entry.raw_offset, entry.plies))
+            return false;
+        game.result = Record_result(entry.result);
+        return true;
+    }
+
+    // Последовательный проход по всем партиям: f(номер, партия). Возвращает число прочитанных партий
+    template <class F> uint64_t for_each(F f)
+    {
+        data.advise_sequential();
+        index.advise_sequential();
+        Game_record game;
+        uint64_t done = 0;
+        for (uint64_t n = 0; n < count; ++n)
+            if (read(n, game))
+            {
+                f(n, game);
+                ++done;
+            }
+        return done;
+    }
+
+private:
+    // Файл, отображённый в память только для чтения
+    struct Mapping
+    {
+        const char* base = nullptr;
+        size_t size = 0;
+#ifdef _WIN32
+        HANDLE file = nullptr;
+        HANDLE mapping = nullptr;
+#endif
+
+        bool map(const std::string& path)
+        {
+#ifdef _WIN32
+            file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING,
+                FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE)
+            {
+                file = nullptr;
+                return false;
+            }
+            LARGE_INTEGER cur;
+            GetFileSizeEx(file, &cur);
+            size = size_t(cur.QuadPart);
+            mapping = size ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+            base = mapping ? static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+            return base != nullptr;
+#else
+            const int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+                return false;
+            struct stat st;
+            fstat(fd, &st);
+            size = size_t(st.st_size);
+            void* addr = size ? mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+            ::close(fd); // отображение остаётся действительным и без дескриптора
+            if (addr == MAP_FAILED)
+                return false;
+            base = static_cast<const char*>(addr);
+            return true;
+#endif
+        }
+
+        void unmap()
+        {
+#ifdef _WIN32
+            if (base)
+                UnmapViewOfFile(base);
+            if (mapping)
+                CloseHandle(mapping);
+            if (file)
+                CloseHandle(file);
+            mapping = file = nullptr;
+#else
+            if (base)
+                munmap(const_cast<char*>(base), size);
+#endif
+            base = nullptr;
+            size = 0;
+        }
+
+        void advise_sequential() const
+        {
+#ifndef _WIN32
+            if (base)
+                madvise(const_cast<char*>(base), size, MADV_SEQUENTIAL);
+#endif
+        }
+    };
+
+    bool block_fits(const uint64_t offset) const
+    {
+        if (offset + sizeof(Game_archive::Block_header) > data.size)
+            return false;
+        const auto* header = reinterpret_cast<const Game_archive::Block_header*>(data.base + offset);
+        return offset + sizeof(*header) + header->packed_size <= data.size;
+    }
+
+    // Распаковка блока в кэш (если там не он)
+    bool load_block(const uint64_t offset)
+    {
+        if (offset == cached_offset)
+            return true;
+        cached_offset = UINT64_MAX;
+        if (!block_fits(offset))
+            return false;
+        const auto* header = reinterpret_cast<const Game_archive::Block_header*>(data.base + offset);
+        cache.resize(header->raw_size);
+        uLongf raw_size = header->raw_size;
+        if (uncompress(cache.data(), &raw_size, reinterpret_cast<const Bytef*>(header + 1), header->packed_size) !=
+                Z_OK ||
+            raw_size != header->raw_size || crc32(0L, cache.data(), uInt(raw_size)) != header->crc)
+            return false;
+        cached_offset = offset;
+        return true;
+    }
+
+    Mapping data;
+    Mapping index;
+    const Game_archive::Index_entry* entries = nullptr;
+    uint64_t count = 0;
+    std::vector<uint8_t> cache; // распакованный блок
+    uint64_t cached_offset = UINT64_MAX;
+};
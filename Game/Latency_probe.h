@@ -0,0 +1,252 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "../Models/Move.h"
+
+// Замер задержки отклика игры (Tools/latency). Отметки времени ставят игра и сценарий, который кликает за игрока:
+//  - inject  — сценарий положил событие мыши в очередь SDL;
+//  - input   — Hand::get_cell получил клик от главного потока;
+//  - state   — Board::rerender отправил главному потоку первое состояние после клика (подсветку или ход);
+//  - present — главный поток показал это состояние или более новое (после SDL_RenderPresent).
+// Замер CLICK — от клика до его подсветки или хода, BOT_REPLY — от клика, которым игрок закончил ход, до
+// первого кадра ответа бота (вместе с поиском). Клик без изменения на доске (мимо фигур) отбрасывается
+// следующим кликом. Игра также сообщает сценарию, что ждёт хода игрока (позиция и размер окна) и что партия
+// закончена. Пока замер выключен, каждая отметка стоит одну проверку флага.
+class Latency_probe
+{
+public:
+    enum Kind
+    {
+        CLICK,
+        BOT_REPLY
+    };
+
+    // Время отметок в микросекундах от старта программы; -1 — отметки нет
+    struct Sample
+    {
+        Kind kind = CLICK;
+        int64_t inject_us = -1; // нет у кликов не от сценария
+        int64_t input_us = -1;
+        int64_t state_us = -1;
+        int64_t present_us = -1;
+        uint64_t seq = 0;       // номер состояния (кадра) на отрисовку
+    };
+
+    // Сообщение игры сценарию
+    struct Notice
+    {
+        enum Type
+        {
+            NONE,
+            PLAYER_TURN, // ждёт хода игрока цвета color в позиции mtx
+            GAME_OVER    // показан итог, ждёт «повтор» или выход
+        };
+        Type type = NONE;
+        uint64_t id = 0; // номер сообщения
+        std::vector<std::vector<POS_T>> mtx;
+        bool color = false;
+        int width = 0; // размер окна в координатах событий мыши
+        int height = 0;
+    };
+
+    static void set_enabled(const bool enabled)
+    {
+        state().enabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    static bool is_enabled()
+    {
+        return state().enabled.load(std::memory_order_relaxed);
+    }
+
+    static int64_t now_us()
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - state().start)
+            .count();
+    }
+
+    // Сценарий: событие мыши положено в очередь
+    static void on_inject()
+    {
+        if (!is_enabled())
+            return;
+        std::lock_guard<std::mutex> lock(state().mtx);
+        state().inject_us = now_us();
+    }
+
+    // Hand: клик забран из очереди
+    static void on_input()
+    {
+        if (!is_enabled())
+            return;
+        State& st = state();
+        std::lock_guard<std::mutex> lock(st.mtx);
+        drop_unanswered(st);
+        Sample sample;
+        sample.inject_us = st.inject_us;
+        sample.input_us = now_us();
+        st.inject_us = -1;
+        st.open.push_back(sample);
+        st.last_input_us = sample.input_us;
+        st.last_inject_us = sample.inject_us;
+    }
+
+    // Game: бот начал ход
+    static void on_bot_turn()
+    {
+        if (!is_enabled())
+            return;
+        State& st = state();
+        std::lock_guard<std::mutex> lock(st.mtx);
+        if (st.last_input_us < 0) // ход бота после хода бота
+            return;
+        Sample sample;
+        sample.kind = BOT_REPLY;
+        sample.inject_us = st.last_inject_us;
+        sample.input_us = st.last_input_us;
+        st.open.push_back(sample);
+        st.last_input_us = -1;
+    }
+
+    // Board::rerender: состояние seq отправлено на отрисовку
+    static void on_frame(const uint64_t seq)
+    {
+        if (!is_enabled())
+            return;
+        State& st = state();
+        std::lock_guard<std::mutex> lock(st.mtx);
+        for (auto& sample : st.open)
+            if (sample.state_us < 0)
+            {
+                sample.state_us = now_us();
+                sample.seq = seq;
+            }
+    }
+
+    // Поток отрисовки: показан кадр состояния seq
+    static void on_present(const uint64_t seq)
+    {
+        if (!is_enabled())
+            return;
+        State& st = state();
+        std::unique_lock<std::mutex> lock(st.mtx);
+        bool done = false;
+        for (size_t i = 0; i < st.open.size();)
+        {
+            Sample& sample = st.open[i];
+            if (sample.state_us >= 0 && sample.seq <= seq)
+            {
+                sample.present_us = now_us();
+                st.samples.push_back(sample);
+                st.open.erase(st.open.begin() + i);
+                done = true;
+            }
+            else
+                ++i;
+        }
+        lock.unlock();
+        if (done)
+            st.cv.notify_all();
+    }
+
+    static void on_player_turn(const std::vector<std::vector<POS_T>>& mtx, const bool color, const int width,
+        const int height)
+    {
+        if (!is_enabled())
+            return;
+        State& st = state();
+        {
+            std::lock_guard<std::mutex> lock(st.mtx);
+            st.notice.type = Notice::PLAYER_TURN;
+            st.notice.mtx = mtx;
+            st.notice.color = color;
+            st.notice.width = width;
+            st.notice.height = height;
+            ++st.notice.id;
+        }
+        st.cv.notify_all();
+    }
+
+    static void on_game_over()
+    {
+        if (!is_enabled())
+            return;
+        State& st = state();
+        {
+            std::lock_guard<std::mutex> lock(st.mtx);
+            st.notice.type = Notice::GAME_OVER;
+            ++st.notice.id;
+        }
+        st.cv.notify_all();
+    }
+
+    // Сценарий: сообщение новее last_id (false — не пришло за timeout)
+    static bool wait_notice(const uint64_t last_id, Notice& out, const std::chrono::milliseconds timeout)
+    {
+        State& st = state();
+        std::unique_lock<std::mutex> lock(st.mtx);
+        if (!st.cv.wait_for(lock, timeout, [&] { return st.notice.id > last_id; }))
+            return false;
+        out = st.notice;
+        return true;
+    }
+
+    // Сценарий: все клики показаны на экране (false — не за timeout)
+    static bool wait_presented(const std::chrono::milliseconds timeout)
+    {
+        State& st = state();
+        std::unique_lock<std::mutex> lock(st.mtx);
+        return st.cv.wait_for(lock, timeout, [&] {
+            for (const auto& sample : st.open)
+                if (sample.kind == CLICK)
+                    return false;
+            return true;
+        });
+    }
+
+    // Законченные замеры
+    static std::vector<Sample> samples()
+    {
+        std::lock_guard<std::mutex> lock(state().mtx);
+        return state().samples;
+    }
+
+private:
+    struct State
+    {
+        std::atomic<bool> enabled{ false };
+        std::mutex mtx;
+        std::condition_variable cv;
+        std::vector<Sample> open;    // ждут состояния или кадра
+        std::vector<Sample> samples; // законченные
+        int64_t inject_us = -1;      // событие сценария, ещё не забранное Hand
+        int64_t last_input_us = -1;  // последний клик до хода бота
+        int64_t last_inject_us = -1;
+        Notice notice;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    };
+
+    static State& state()
+    {
+        static State st;
+        return st;
+    }
+
+    // Клики, после которых доска не изменилась
+    static void drop_unanswered(State& st)
+    {
+        for (size_t i = 0; i < st.open.size();)
+        {
+            if (st.open[i].kind == CLICK && st.open[i].state_us < 0)
+                st.open.erase(st.open.begin() + i);
+            else
+                ++i;
+        }
+    }
+};
@@ -0,0 +1,97 @@
+#pragma once
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <nlohmann/json.hpp>
+
+#include "../Models/Search_stats.h"
+
+// Структурированный журнал: одна JSON-запись на строку (JSON lines).
+// Записи копятся в памяти и сбрасываются в файл пачками, файл открыт всё время работы.
+// Можно писать из нескольких потоков. Пустой путь — журнал выключен.
+class Logger
+{
+public:
+    explicit Logger(const std::string& path = "")
+    {
+        if (!path.empty())
+            fout.open(path, std::ios_base::app);
+    }
+
+    ~Logger()
+    {
+        flush();
+    }
+
+    bool enabled() const
+    {
+        return fout.is_open();
+    }
+
+    void write(const nlohmann::json& record)
+    {
+        if (!enabled())
+            return;
+        std::lock_guard<std::mutex> lock(mtx);
+        buf += record.dump();
+        buf += '\n';
+        if (buf.size() >= BUF_SIZE)
+            flush_locked();
+    }
+
+    void flush()
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        flush_locked();
+    }
+
+    // Запись статистики поиска
+    static nlohmann::json to_json(const Search_stats& stats)
+    {
+        nlohmann::json js;
+        js["depth"] = stats.depth;
+        js["time_ms"] = stats.time_ms;
+        js["nodes"] = stats.nodes;
+        js["nps"] = stats.nps();
+        js["leaves"] = stats.leaves;
+        js["cutoffs"] = stats.cutoffs;
+        js["first_move_cutoff_rate"] = stats.first_move_cutoff_rate();
+        js["branching_factor"] = stats.branching_factor();
+        js["tt_hit_rate"] = stats.tt_hit_rate();
+        js["tt_cutoffs"] = stats.tt_cutoffs;
+        js["persistent_hits"] = stats.persistent_hits;
+        js["repetitions"] = stats.repetitions;
+        js["iteration_ms"] = stats.iteration_ms;
+        return js;
+    }
+
+    static nlohmann::json to_json(const Mcts_stats& stats)
+    {
+        nlohmann::json js;
+        js["engine"] = "mcts";
+        js["time_ms"] = stats.time_ms;
+        js["playouts"] = stats.playouts;
+        js["playouts_per_second"] = stats.playouts_per_second();
+        js["tree_nodes"] = stats.tree_nodes;
+        js["reused_nodes"] = stats.reused;
+        js["max_depth"] = stats.max_depth;
+        js["threads"] = stats.threads;
+        js["pool_full"] = stats.pool_full;
+        return js;
+    }
+
+private:
+    void flush_locked()
+    {
+        if (!enabled() || buf.empty())
+            return;
+        fout << buf;
+        fout.flush();
+        buf.clear();
+    }
+
+    static const size_t BUF_SIZE = 1 << 16;
+    std::ofstream fout;
+    std::string buf;
+    std::mutex mtx;
+};
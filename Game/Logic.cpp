@@ -0,0 +1,8 @@
+// Библиотека checkers_engine: правила, генерация ходов и поиск без графики.
+// Logic_t всех вариантов правил компилируется здесь один раз; программы, собранные с библиотекой
+// (CHECKERS_ENGINE_LIBRARY), его не инстанцируют заново (extern template в Logic.h).
+#include "Logic.h"
+
+template class Logic_t<Russian_rules>;
+template class Logic_t<English_rules>;
+template class Logic_t<International_rules>;
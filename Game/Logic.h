@@ -1,119 +1,705 @@
 #pragma once
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <memory>
 #include <random>
+#include <string>
 #include <vector>
 
+#include "../Models/Eval_params.h"
 #include "../Models/Move.h"
-#include "Board.h"
+#include "../Models/Position_record.h"
+#include "../Models/Rules.h"
+#include "../Models/Search.h"
+#include "../Models/Search_stats.h"
 #include "Config.h"
+#include "NNUE.h"
+#include "Persistent_table.h"
+#include "Search_recorder.h"
+#include "Trace.h"
+#include "Transposition_table.h"
+#include "Zobrist.h"
 
-const int INF = 1e9; // "бесконечность" для оценки позиций (используется в minimax)
+using namespace std;
 
-class Logic
+// Правила игры задаются политикой Rules (Models/Rules.h): генератор ходов и поиск специализируются
+// под каждый вариант при компиляции. Logic — русские шашки (игра с графикой и утилиты).
+// Logic не зависит от графики (SDL): позиция всегда передаётся матрицей, поэтому правила и поиск
+// собираются отдельной библиотекой checkers_engine (см. CMakeLists.txt и Logic.cpp).
+template <class Rules> class Logic_t
 {
 public:
-    // Конструктор: принимает указатели на доску и конфиг
-    // Инициализирует генератор случайных чисел (для случайного выбора ходов, если разрешено)
-    // Загружает режим оценки и уровень оптимизации из настроек
-    Logic(Board* board, Config* config) : board(board), config(config)
+    // Конструктор: принимает указатель на конфиг
+    // Создаёт таблицы транспозиций и запись дерева поиска (их размер и файл задаются только при создании),
+    // остальные настройки бота применяет apply_settings.
+    // with_tt = false — без своей таблицы: Logic только применяет ходы или получит общую таблицу через set_tt
+    explicit Logic_t(Config* config, const bool with_tt = true) : config(config)
     {
-        rand_eng = std::default_random_engine(
-            !((*config)("Bot", "NoRandom")) ? unsigned(time(0)) : 0);
-        scoring_mode = (*config)("Bot", "BotScoringType");
-        optimization = (*config)("Bot", "Optimization");
+        const Bot_settings& bot = config->settings().bot;
+        if (with_tt && bot.tt_size_mb > 0 && bot.optimization > 0) // O0 — полный перебор без отсечений
+            tt = make_shared<Transposition_table>(bot.tt_size_mb);
+        const Log_settings& log = config->settings().log;
+        if (!log.search_tree.empty())
+            open_recorder(project_path + log.search_tree);
+        apply_settings();
     }
 
-    // Основной метод: поиск лучшего хода для бота
+    // Применение настроек бота (при создании и после перечитывания settings.json между ходами):
+    // генератор случайных чисел, уровень оптимизации, тип уровня и оценка.
+    // Если оценка изменилась, таблица транспозиций очищается — её записи посчитаны прежней оценкой
+    void apply_settings()
+    {
+        const Bot_settings& bot = config->settings().bot;
+        rand_eng.seed(!bot.no_random ? unsigned(time(0)) : 0); // случайный выбор ходов, если разрешён
+        optimization = bot.optimization;
+        level_type = bot.level_type;
+        level_nodes = bot.level_nodes;
+        const string source = bot.scoring_type + '\n' + bot.nn_weights_path + '\n' + bot.eval_params_path;
+        if (source == eval_source)
+            return;
+        const bool reload = !eval_source.empty();
+        eval_source = source;
+        scoring_mode = bot.scoring_type;
+        nn.reset();
+        use_nn = false;
+        if (scoring_mode == "NN")
+            load_nn();
+        load_eval_params();
+        if (reload && tt)
+            tt->clear();
+        persistent_tt.reset();
+        if (!bot.persistent_tt_path.empty() && optimization > 0) // файл таблицы проверяет отпечаток оценки
+            open_persistent_tt(project_path + bot.persistent_tt_path);
+    }
+
+    // Основной метод: поиск лучшего хода для бота в позиции mtx
     // Возвращает последовательность ходов (например, серия взятий)
-    vector<move_pos> find_best_turns(const bool color)
+    vector<move_pos> find_best_turns(const vector<vector<POS_T>>& mtx, const bool color)
     {
-        next_best_state.clear();
-        next_move.clear();
+        if (node_budget) // уровень задан бюджетом узлов — итеративное углубление до его исчерпания
+        {
+            Search_limits limits;
+            limits.depth = 64;
+            limits.nodes = node_budget;
+            return search(mtx, color, limits);
+        }
+        begin_search();
+        auto res = search_iteration(mtx, color);
+        stats.depth = Max_depth + 1;
+        stats.time_ms = elapsed_ms();
+        return res;
+    }
 
-        // запускаем рекурсивный поиск лучшего хода
-        find_first_best_turn(board->get_board(), color, -1, -1, 0);
+    // Поиск с итеративным углублением: глубина растёт, пока не исчерпаны ограничения limits
+    // (или пока не выставлен limits.stop). Возвращает лучший ход последней завершённой итерации;
+    // on_iteration вызывается после каждой завершённой итерации.
+    vector<move_pos> search(const vector<vector<POS_T>>& mtx, const bool color, const Search_limits& limits,
+        const function<void(const Search_info&)>& on_iteration = nullptr)
+    {
+        vector<Search_line> root; // полные ходы корня (серии взятий до конца) — для проверки единственного хода
+        vector<move_pos> chain;
+        expand_root(mtx, color, chain, root);
 
-        int cur_state = 0;
-        vector<move_pos> res;
-        // восстанавливаем цепочку ходов из next_move/next_best_state
-        do
+        const int saved_depth = Max_depth;
+        const int max_plies = (limits.depth > 0 ? limits.depth : Max_depth + 1);
+        begin_search();
+        search_limits = limits;
+        vector<move_pos> best;
+        for (int plies = 1; plies <= max_plies; ++plies)
         {
-            res.push_back(next_move[cur_state]);
-            cur_state = next_best_state[cur_state];
-        } while (cur_state != -1 && next_move[cur_state].x != -1);
-        return res;
+            Max_depth = plies - 1;
+            can_abort = (plies > 1); // первая итерация всегда доводится до конца, чтобы был ход
+            aborted = false;
+            auto res = search_iteration(mtx, color);
+            if (aborted)
+                break;
+            best = res;
+            stats.depth = plies;
+            if (on_iteration)
+            {
+                Search_info info;
+                info.depth = plies;
+                info.score = last_score;
+                info.nodes = stats.nodes;
+                info.time_ms = elapsed_ms();
+                info.pv = unpack_line(mtx, pv_table[0]);
+                on_iteration(info);
+            }
+            // дальше углубляться бессмысленно: выигрыш/проигрыш уже найден (кратчайший — итерации идут
+            // по возрастанию глубины) или ход единственный (вместе со всеми продолжениями серии взятий)
+            if (is_decisive_score(last_score) || root.size() <= 1)
+                break;
+        }
+        Max_depth = saved_depth;
+        can_abort = false;
+        stats.time_ms = elapsed_ms();
+        return best;
+    }
+
+    // Анализ нескольких вариантов (multi-PV): до count лучших ходов с оценками и главными вариантами
+    // за один поиск с итеративным углублением (ограничения — как в search). Ходы сортируются по убыванию
+    // оценки; оценки точные: ход проверяется с нижней границей, равной оценке count-го из лучших.
+    // on_iteration вызывается после каждой завершённой итерации (info — о лучшем ходе).
+    vector<Search_line> search_multipv(const vector<vector<POS_T>>& mtx, const bool color, const size_t count,
+        const Search_limits& limits,
+        const function<void(const Search_info&, const vector<Search_line>&)>& on_iteration = nullptr)
+    {
+        vector<Search_line> root; // все ходы корня, серии взятий развёрнуты до конца
+        vector<move_pos> chain;
+        expand_root(mtx, color, chain, root);
+        if (root.empty() || count == 0)
+            return {};
+
+        const int saved_depth = Max_depth;
+        const int max_plies = (limits.depth > 0 ? limits.depth : Max_depth + 1);
+        begin_search();
+        search_limits = limits;
+        vector<Search_line> best;
+        for (int plies = 1; plies <= max_plies; ++plies)
+        {
+            const long long iteration_start = elapsed_ms();
+            Max_depth = plies - 1;
+            can_abort = (plies > 1);
+            aborted = false;
+            set_root(mtx);
+            vector<Search_line> lines; // лучшие ходы итерации по убыванию оценки
+            for (auto& line : root)
+            {
+                auto cur = mtx;
+                for (const auto& turn : line.turns)
+                {
+                    push_turn(cur, turn);
+                    cur = make_turn(cur, turn);
+                }
+                const int alpha = (lines.size() >= count ? lines.back().score : -SCORE_INF);
+                line.score = -find_best_turns_rec(cur, 1 - color, 0, -SCORE_INF, -alpha);
+                line.pv = line.turns;
+                const auto reply = unpack_line(cur, pv_table[ply]);
+                line.pv.insert(line.pv.end(), reply.begin(), reply.end());
+                for (size_t i = 0; i < line.turns.size(); ++i)
+                    pop_turn();
+                if (aborted)
+                    break;
+                if (lines.size() < count || line.score > alpha)
+                {
+                    auto pos = lines.begin();
+                    while (pos != lines.end() && pos->score >= line.score)
+                        ++pos;
+                    lines.insert(pos, line);
+                    if (lines.size() > count)
+                        lines.pop_back();
+                }
+            }
+            if (aborted)
+                break;
+            stats.iteration_ms.push_back(elapsed_ms() - iteration_start);
+            best = lines;
+            last_score = best[0].score;
+            stats.depth = plies;
+            if (on_iteration)
+            {
+                Search_info info;
+                info.depth = plies;
+                info.score = last_score;
+                info.nodes = stats.nodes;
+                info.time_ms = elapsed_ms();
+                info.pv = best[0].pv;
+                on_iteration(info, best);
+            }
+            // в следующей итерации сначала проверяются лучшие ходы: нижняя граница растёт быстрее
+            stable_sort(root.begin(), root.end(),
+                [](const Search_line& a, const Search_line& b) { return a.score > b.score; });
+            // дальше углубляться бессмысленно: ход единственный, все лучшие ходы выигрывают или все проигрывают
+            if (root.size() == 1 || best.back().score > SCORE_MAX_EVAL || best[0].score < -SCORE_MAX_EVAL)
+                break;
+        }
+        Max_depth = saved_depth;
+        can_abort = false;
+        stats.time_ms = elapsed_ms();
+        return best;
+    }
+
+    // Уровень сложности бота: при "LevelType": "Depth" — глубина поиска (Max_depth = level),
+    // при "Nodes" — бюджет узлов LevelNodes * 4^level, не зависящий от скорости машины (при переполнении — без предела)
+    void set_level(const int level)
+    {
+        Max_depth = level;
+        node_budget = 0;
+        if (level_type != Level_type::NODES)
+            return;
+        const int shift = 2 * min(max(level, 0), 20);
+        const long long max_nodes = numeric_limits<long long>::max();
+        node_budget = (level_nodes > (max_nodes >> shift) ? max_nodes : level_nodes << shift);
+    }
+
+    // Статическая оценка позиции для цвета color (та же шкала, что у поиска: 0 — равенство)
+    int evaluate(const vector<vector<POS_T>>& mtx, const bool color)
+    {
+        ply = 0;
+        depth_from_root = 0;
+        if (use_nn)
+            nn->refresh(nn_stack[0], mtx);
+        return calc_score(mtx, color);
+    }
+
+    // История партии для поиска: хеши расстановки (Zobrist::board_hash) позиций в начале ходов после последнего
+    // взятия или хода простой шашкой, от старых к новым, без текущей (Position_history::reversible_hashes).
+    // Повторение позиции из истории или с пути поиска оценивается как ничья.
+    void set_history(const vector<uint64_t>& hashes)
+    {
+        game_hashes = hashes;
+    }
+
+    // Статистика последнего поиска
+    const Search_stats& get_stats() const
+    {
+        return stats;
+    }
+
+    // Использовать общую таблицу транспозиций (например, одну на несколько партий); nullptr — без таблицы
+    void set_tt(const shared_ptr<Transposition_table>& table)
+    {
+        tt = table;
+    }
+
+    shared_ptr<Transposition_table> get_tt() const
+    {
+        return tt;
+    }
+
+    // Закрыть файловую таблицу: пока она открыта, Logic с другой оценкой не может её очистить
+    void close_persistent_tt()
+    {
+        persistent_tt.reset();
+    }
+
+    // Задать зерно генератора случайных чисел (чтобы параллельные боты не повторяли друг друга)
+    void set_seed(const unsigned seed)
+    {
+        rand_eng.seed(seed);
     }
 
-private:
     // Применение хода к копии доски (матрице)
     // Возвращает новую матрицу после хода
     vector<vector<POS_T>> make_turn(vector<vector<POS_T>> mtx, move_pos turn) const
     {
-        if (turn.xb != -1) // если было взятие — удаляем побитую шашку
-            mtx[turn.xb][turn.yb] = 0;
+        // превращение в дамку (если шашка дошла до последней линии) — по правилам варианта
+        const POS_T type = moved_type(mtx, turn);
+        const bool ends = ends_turn(mtx, turn);
 
-        // превращение в дамку (если шашка дошла до последней линии)
-        if ((mtx[turn.x][turn.y] == 1 && turn.x2 == 0) || (mtx[turn.x][turn.y] == 2 && turn.x2 == 7))
-            mtx[turn.x][turn.y] += 2;
+        if (turn.xb != -1) // если было взятие — удаляем побитую шашку (или оставляем до конца серии)
+            mtx[turn.xb][turn.yb] = (Rules::CAPTURED_STAY ? captured_marker(type) : 0);
 
         // перемещаем шашку
-        mtx[turn.x2][turn.y2] = mtx[turn.x][turn.y];
+        mtx[turn.x2][turn.y2] = type;
         mtx[turn.x][turn.y] = 0;
+
+        // серия закончилась — побитые фигуры снимаются с доски
+        if constexpr (Rules::CAPTURED_STAY)
+        {
+            vector<move_pos> next;
+            if (turn.xb != -1 && (ends || !find_piece_turns(turn.x2, turn.y2, mtx, next)))
+                for (auto& row : mtx)
+                    for (auto& cell : row)
+                        if (cell > 4)
+                            cell = 0;
+        }
         return mtx;
     }
 
-    // Функция оценки позиции (чем выше — тем лучше для бота)
-    double calc_score(const vector<vector<POS_T>>& mtx, const bool first_bot_color) const
+    // Фигура на клетке назначения после хода turn (на доске mtx до хода)
+    POS_T moved_type(const vector<vector<POS_T>>& mtx, const move_pos& turn) const
+    {
+        const POS_T type = mtx[turn.x][turn.y];
+        if (!is_promotion_row<Rules>(type, turn.x2))
+            return type;
+        // при Promotion_rule::AT_END_ONLY шашка проходит дамочное поле, не превращаясь, если бьёт дальше
+        if constexpr (Rules::PROMOTION == Promotion_rule::AT_END_ONLY)
+        {
+            if (turn.xb != -1 && man_can_capture(mtx, turn))
+                return type;
+        }
+        return type + 2;
+    }
+
+    // Применение хода, заданного номерами клеток 0..31 (откуда, куда, куда...), к позиции mtx.
+    // Возвращает false, если такого хода (или полной серии взятий) нет; mtx при этом не меняется.
+    bool make_turn_by_squares(vector<vector<POS_T>>& mtx, const bool color, const vector<int>& squares)
+    {
+        if (squares.size() < 2) // ход не разобран (parse_move вернул пустой список)
+            return false;
+        auto res = mtx;
+        find_turns(color, res);
+        bool chain_over = false; // серия закончилась превращением (Promotion_rule::ENDS_MOVE)
+        for (size_t i = 0; i + 1 < squares.size(); ++i)
+        {
+            if (i > 0)
+            {
+                if (chain_over)
+                    return false;
+                find_turns(rules_square_x<Rules>(squares[i]), rules_square_y<Rules>(squares[i]), res);
+                if (!have_beats)
+                    return false;
+            }
+            bool found = false;
+            for (auto turn : turns)
+            {
+                if (rules_square<Rules>(turn.x, turn.y) == squares[i] &&
+                    rules_square<Rules>(turn.x2, turn.y2) == squares[i + 1])
+                {
+                    chain_over = ends_turn(res, turn);
+                    res = make_turn(res, turn);
+                    found = true;
+                    break;
+                }
+            }
+            if (!found)
+                return false;
+        }
+        // серия взятий должна быть доведена до конца
+        if (have_beats && !chain_over)
+        {
+            find_turns(rules_square_x<Rules>(squares.back()), rules_square_y<Rules>(squares.back()), res);
+            if (have_beats)
+                return false;
+        }
+        mtx = res;
+        return true;
+    }
+
+private:
+    // Сброс статистики и ограничений перед новым поиском
+    void begin_search()
     {
-        double w = 0, wq = 0, b = 0, bq = 0; // счётчики белых/чёрных шашек и дамок
-        for (POS_T i = 0; i < 8; ++i)
+        stats = Search_stats();
+        search_limits = Search_limits();
+        search_start = chrono::steady_clock::now();
+        if (tt)
+            tt->new_search();
+    }
+
+    // Корень поиска: хеш и аккумулятор нейросети считаются полностью, дальше — только инкрементально
+    void set_root(const vector<vector<POS_T>>& mtx)
+    {
+        ply = 0;
+        hash_stack[0] = Zobrist::get().board_hash<Rules>(mtx);
+        clock_stack[0] = int(game_hashes.size());
+        if (use_nn)
+            nn->refresh(nn_stack[0], mtx);
+    }
+
+    // Все полные ходы позиции: серия взятий разворачивается до конца (один ход — одна серия)
+    void expand_root(const vector<vector<POS_T>>& mtx, const bool color, vector<move_pos>& chain,
+        vector<Search_line>& out, const POS_T x = -1, const POS_T y = -1)
+    {
+        if (x == -1)
+            find_turns(color, mtx);
+        else
+            find_turns(x, y, mtx);
+        if (x != -1 && !have_beats) // серия взятий закончилась
         {
-            for (POS_T j = 0; j < 8; ++j)
+            out.emplace_back();
+            out.back().turns = chain;
+            return;
+        }
+        const auto turns_now = turns;
+        const bool have_beats_now = have_beats;
+        for (const auto& turn : turns_now)
+        {
+            chain.push_back(turn);
+            if (have_beats_now && !ends_turn(mtx, turn))
+                expand_root(make_turn(mtx, turn), color, chain, out, turn.x2, turn.y2);
+            else
             {
-                w += (mtx[i][j] == 1);
-                wq += (mtx[i][j] == 3);
-                b += (mtx[i][j] == 2);
-                bq += (mtx[i][j] == 4);
+                out.emplace_back();
+                out.back().turns = chain;
+            }
+            chain.pop_back();
+        }
+    }
+
+    // Одна итерация поиска на глубину Max_depth + 1
+    vector<move_pos> search_iteration(const vector<vector<POS_T>>& mtx, const bool color)
+    {
+        TRACE_SCOPE("Logic::search_iteration");
+        const long long iteration_start = elapsed_ms();
+        next_best_state.clear();
+        next_move.clear();
+        find_turns(color, mtx);
+        root_turns = turns.size();
+        set_root(mtx);
+        recording = recorder.get();
+        if (recording)
+            recording->begin_iteration(Max_depth + 1, root_turns, stats.nodes);
+
+        // запускаем рекурсивный поиск лучшего хода
+        last_score = find_first_best_turn(mtx, color, -1, -1, 0);
+        stats.iteration_ms.push_back(elapsed_ms() - iteration_start);
+        if (recording)
+            recording->end_iteration(last_score, stats.nodes, aborted);
+        recording = nullptr;
+
+        int cur_state = 0;
+        vector<move_pos> res;
+        if (next_move.empty() || next_move[0].x == -1) // ходов нет — партия проиграна
+            return res;
+        // восстанавливаем цепочку ходов из next_move/next_best_state
+        do
+        {
+            res.push_back(next_move[cur_state]);
+            cur_state = next_best_state[cur_state];
+        } while (cur_state != -1 && next_move[cur_state].x != -1);
+        return res;
+    }
 
-                // если включён режим "NumberAndPotential" — учитываем продвижение вперёд
-                if (scoring_mode == "NumberAndPotential")
+    // Функция оценки позиции для цвета color (чем выше — тем лучше для него):
+    // логарифм отношения сил сторон * 1000, как и у поиска
+    int calc_score(const vector<vector<POS_T>>& mtx, const bool color) const
+    {
+        if (use_nn)
+            return calc_nn_score(color);
+
+        double w = 0, b = 0; // сила белых и чёрных
+        int wn = 0, bn = 0;  // количество фигур белых и чёрных
+        for (POS_T i = 0; i < Rules::SIZE; ++i)
+        {
+            for (POS_T j = 0; j < Rules::SIZE; ++j)
+            {
+                POS_T type = mtx[i][j];
+                if (!type)
+                    continue;
+                // вклад фигуры берётся из таблицы, построенной по параметрам оценки
+                if (type % 2)
                 {
-                    w += 0.05 * (mtx[i][j] == 1) * (7 - i); // белые ценнее ближе к дамкам
-                    b += 0.05 * (mtx[i][j] == 2) * (i);     // чёрные ценнее ближе к дамкам
+                    w += piece_score[type][i][j];
+                    ++wn;
+                }
+                else
+                {
+                    b += piece_score[type][i][j];
+                    ++bn;
                 }
             }
         }
 
-        // если бот играет за чёрных — меняем местами оценки
-        if (!first_bot_color)
+        // оценка для белых — меняем местами
+        if (!color)
         {
             swap(b, w);
-            swap(bq, wq);
+            swap(bn, wn);
         }
 
-        // если у соперника нет шашек — победа
-        if (w + wq == 0)
-            return INF;
-        // если у бота нет шашек — поражение
-        if (b + bq == 0)
-            return 0;
+        // если у соперника нет шашек — победа, если у себя — поражение
+        if (wn == 0)
+            return SCORE_WIN - int(depth_from_root);
+        if (bn == 0)
+            return -SCORE_WIN + int(depth_from_root);
 
-        int q_coef = 4; // коэффициент ценности дамки
-        if (scoring_mode == "NumberAndPotential")
+        // итоговая оценка: логарифм отношения сил
+        return eval_clamp(lround(1000 * log(b / w)));
+    }
+
+    static int eval_clamp(const long long score)
+    {
+        return int(max<long long>(-SCORE_MAX_EVAL, min<long long>(SCORE_MAX_EVAL, score)));
+    }
+
+    // Загрузка параметров оценки: встроенные значения режима, которые можно переопределить
+    // файлом EvalParamsPath (его создаёт утилита Tools/tune.cpp)
+    void load_eval_params()
+    {
+        eval_params = Eval_params::defaults(scoring_mode);
+        const string& path = config->settings().bot.eval_params_path;
+        if (!path.empty() && !eval_params.load(project_path + path))
+        {
+            ofstream fout(project_path + "log.txt", ios_base::app);
+            fout << "Error: can't load eval params from " << project_path + path << ". Using defaults.\n";
+            fout.close();
+        }
+        for (POS_T type = 1; type <= 4; ++type)
+            for (POS_T i = 0; i < Rules::SIZE; ++i)
+                for (POS_T j = 0; j < Rules::SIZE; ++j)
+                    piece_score[type][i][j] = eval_params.piece_value(type, i, j, Rules::SIZE);
+    }
+
+    // Оценка нейросетью по текущему аккумулятору для цвета color (как в calc_score).
+    // Сеть выдаёт логит вероятности победы, т.е. логарифм отношения шансов — та же шкала, что в calc_score
+    int calc_nn_score(const bool color) const
+    {
+        const NNUE::Accumulator& acc = nn_stack[ply];
+        if (acc.pieces[!color] == 0)
+            return SCORE_WIN - int(depth_from_root);
+        if (acc.pieces[color] == 0)
+            return -SCORE_WIN + int(depth_from_root);
+        return eval_clamp(1000ll * nn->evaluate(acc, color) / NNUE::OUTPUT_SCALE);
+    }
+
+    // Файловая таблица глубоких результатов (PersistentTTPath): переживает перезапуск партии и программы
+    void open_persistent_tt(const string& path)
+    {
+        persistent_min_depth = config->settings().bot.persistent_tt_min_depth;
+        const size_t size_mb = config->settings().bot.persistent_tt_size_mb;
+        auto table = make_shared<Persistent_table>();
+        if (!table->open(path, size_mb, eval_fingerprint()))
         {
-            q_coef = 5;
+            ofstream fout(project_path + "log.txt", ios_base::app);
+            fout << "Error: can't open persistent transposition table " << path
+                 << " (or it is open with a different evaluation).\n";
+            fout.close();
+            return;
         }
+        persistent_tt = table;
+    }
 
-        // итоговая оценка: отношение силы бота к силе соперника
-        return (b + bq * q_coef) / (w + wq * q_coef);
+    // Запись дерева поиска (Log/SearchTree): узлы итераций search и find_best_turns для Tools/treestat
+    void open_recorder(const string& path)
+    {
+        const Log_settings& log = config->settings().log;
+        auto rec = make_shared<Search_recorder>(path, log.search_tree_levels, log.search_tree_sample_level,
+            log.search_tree_sample);
+        if (!rec->is_open())
+        {
+            ofstream fout(project_path + "log.txt", ios_base::app);
+            fout << "Error: can't open search tree file " << path << ".\n";
+            fout.close();
+            return;
+        }
+        recorder = rec;
     }
 
-    // Рекурсивный поиск первого лучшего хода (для серии взятий)
-    double find_first_best_turn(vector<vector<POS_T>> mtx, const bool color, const POS_T x, const POS_T y, size_t state,
-        double alpha = -1)
+    // Отпечаток функции оценки: записи таблицы в файле верны только для той же оценки
+    uint64_t eval_fingerprint() const
+    {
+        uint64_t hash = Persistent_table::fingerprint(&use_nn, sizeof(use_nn));
+        if (use_nn)
+            return nn->checksum(hash);
+        return Persistent_table::fingerprint(piece_score[1], sizeof(piece_score) - sizeof(piece_score[0]), hash);
+    }
+
+    // Загрузка весов нейросети; при ошибке бот откатывается на "NumberAndPotential"
+    void load_nn()
+    {
+        if constexpr (Rules::SIZE != 8) // входы сети — 32 клетки доски 8x8
+        {
+            ofstream fout(project_path + "log.txt", ios_base::app);
+            fout << "Error: NN scoring supports only 8x8 boards. Using NumberAndPotential scoring.\n";
+            fout.close();
+            scoring_mode = "NumberAndPotential";
+            return;
+        }
+        const string& path = config->settings().bot.nn_weights_path;
+        auto net = make_shared<NNUE>();
+        if (!net->load(project_path + path))
+        {
+            ofstream fout(project_path + "log.txt", ios_base::app);
+            fout << "Error: can't load NN weights from " << project_path + path
+                 << ". Using NumberAndPotential scoring.\n";
+            fout.close();
+            scoring_mode = "NumberAndPotential";
+            return;
+        }
+        nn = net;
+        use_nn = true;
+        nn_stack.resize(NN_STACK_SIZE);
+    }
+
+    // Ход вглубь по пути поиска (make): растёт ply, инкрементально обновляются хеш позиции
+    // и аккумулятор нейросети
+    void push_turn(const vector<vector<POS_T>>& mtx, const move_pos& turn)
+    {
+        if (ply + 2 >= pv_table.size())
+        {
+            pv_table.resize(pv_table.size() * 2 + 2);
+            hash_stack.resize(pv_table.size());
+            clock_stack.resize(pv_table.size());
+        }
+        hash_stack[ply + 1] = hash_stack[ply] ^ Zobrist::get().turn_delta<Rules>(mtx, turn, moved_type(mtx, turn));
+        // обратим только ход дамки без взятия
+        clock_stack[ply + 1] = (turn.xb == -1 && mtx[turn.x][turn.y] > 2 ? clock_stack[ply] + 1 : 0);
+        if (use_nn)
+        {
+            if (ply + 1 == nn_stack.size())
+                nn_stack.resize(nn_stack.size() * 2);
+            nn->update(nn_stack[ply], nn_stack[ply + 1], mtx, turn);
+        }
+        ++ply;
+        pv_table[ply].clear();
+        if (recording)
+            recording->push_move(pack_move<Rules>(turn));
+    }
+
+    // Возврат по пути поиска (unmake)
+    void pop_turn()
+    {
+        --ply;
+    }
+
+    // Улучшение в текущем узле: главный вариант = turn + главный вариант ответа
+    void update_pv(const move_pos& turn)
+    {
+        auto& line = pv_table[ply];
+        line.clear();
+        line.push_back(pack_move<Rules>(turn));
+        line.insert(line.end(), pv_table[ply + 1].begin(), pv_table[ply + 1].end());
+    }
+
+    // Главный вариант из упакованных ходов: побитые фигуры находятся по доске, начиная с позиции mtx
+    vector<move_pos> unpack_line(vector<vector<POS_T>> mtx, const vector<Packed_move>& line) const
+    {
+        vector<move_pos> res;
+        for (const Packed_move move : line)
+        {
+            res.push_back(unpack_move<Rules>(move, mtx));
+            mtx = make_turn(mtx, res.back());
+        }
+        return res;
+    }
+
+    // Повторилась ли позиция на вершине пути (в начале хода) — на пути поиска или в истории партии.
+    // После последнего необратимого хода каждый ход — один полуход, поэтому та же очередь хода через 2, 4, ...
+    bool is_repetition() const
+    {
+        for (int back = 2; back <= clock_stack[ply]; back += 2)
+        {
+            const uint64_t prev = (size_t(back) <= ply ? hash_stack[ply - back]
+                                                       : game_hashes[game_hashes.size() - (back - ply)]);
+            if (prev == hash_stack[ply])
+                return true;
+        }
+        return false;
+    }
+
+    // Проверка ограничений поиска (узлы, время, внешний флаг остановки); время проверяется раз в 1024 узла
+    bool out_of_limits()
+    {
+        if (!can_abort || aborted)
+            return aborted;
+        if ((search_limits.stop && search_limits.stop->load(memory_order_relaxed)) ||
+            (search_limits.nodes && stats.nodes >= search_limits.nodes) ||
+            (search_limits.time_ms && (stats.nodes & 1023) == 0 && elapsed_ms() >= search_limits.time_ms))
+            aborted = true;
+        return aborted;
+    }
+
+    long long elapsed_ms() const
+    {
+        return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - search_start).count();
+    }
+
+    // Рекурсивный поиск первого лучшего хода (для серии взятий); оценка — для бота (color)
+    int find_first_best_turn(vector<vector<POS_T>> mtx, const bool color, const POS_T x, const POS_T y, size_t state,
+        int alpha = -SCORE_INF)
     {
         next_best_state.push_back(-1);
         next_move.emplace_back(-1, -1, -1, -1);
-        double best_score = -1;
+        int best_score = -SCORE_INF;
+        ++stats.nodes;
+        pv_table[ply].clear();
 
         if (state != 0)
             find_turns(x, y, mtx); // ищем ходы для конкретной шашки
@@ -124,38 +710,117 @@ private:
         // если нет взятий — передаём ход сопернику
         if (!have_beats_now && state != 0)
         {
-            return find_best_turns_rec(mtx, 1 - color, 0, alpha);
+            return -find_best_turns_rec(mtx, 1 - color, 0, -SCORE_INF, -alpha);
         }
+        if (turns_now.empty()) // ходов нет — партия проиграна
+            return -SCORE_WIN;
 
         for (auto turn : turns_now)
         {
             size_t next_state = next_move.size();
-            double score;
-            if (have_beats_now) // если серия взятий — продолжаем её
+            int score;
+            push_turn(mtx, turn);
+            const bool chain = (have_beats_now && !ends_turn(mtx, turn));
+            if (chain) // если серия взятий — продолжаем её
             {
                 score = find_first_best_turn(make_turn(mtx, turn), color, turn.x2, turn.y2, next_state, best_score);
             }
             else // иначе — передаём ход сопернику
             {
-                score = find_best_turns_rec(make_turn(mtx, turn), 1 - color, 0, best_score);
+                score = -find_best_turns_rec(make_turn(mtx, turn), 1 - color, 0, -SCORE_INF, -best_score);
             }
+            pop_turn();
+            if (aborted) // поиск прерван — результат итерации всё равно будет отброшен
+                return best_score;
             if (score > best_score)
             {
                 best_score = score;
-                next_best_state[state] = (have_beats_now ? int(next_state) : -1);
+                next_best_state[state] = (chain ? int(next_state) : -1);
                 next_move[state] = turn;
+                update_pv(turn);
             }
         }
         return best_score;
     }
 
-    // Рекурсивный minimax с альфа-бета отсечением
-    double find_best_turns_rec(vector<vector<POS_T>> mtx, const bool color, const size_t depth, double alpha = -1,
-        double beta = INF + 1, const POS_T x = -1, const POS_T y = -1)
+    // Рекурсивный negamax с альфа-бета отсечением: оценка для color (стороны, которая ходит).
+    // depth — номер хода от корня (0 — ответ соперника бота), x, y — шашка, продолжающая серию взятий
+    int find_best_turns_rec(vector<vector<POS_T>> mtx, const bool color, const size_t depth, int alpha, int beta,
+        const POS_T x = -1, const POS_T y = -1)
+    {
+        if (!recording)
+            return search_node(move(mtx), color, depth, alpha, beta, x, y);
+        recording->enter(alpha, beta, x != -1, hash_stack[ply], stats.nodes);
+        const int score = search_node(move(mtx), color, depth, alpha, beta, x, y);
+        recording->leave(score, stats.nodes);
+        return score;
+    }
+
+    // Узел поиска find_best_turns_rec (без записи дерева)
+    int search_node(vector<vector<POS_T>> mtx, const bool color, const size_t depth, int alpha, int beta,
+        const POS_T x, const POS_T y)
     {
+        ++stats.nodes;
+        pv_table[ply].clear();
+        depth_from_root = depth + 1; // полуходов от корня до этой позиции
+        if (out_of_limits()) // поиск прерван — значение не важно
+            return 0;
+
+        if (x == -1 && is_repetition()) // повторение позиции — ничья
+        {
+            ++stats.repetitions;
+            return 0;
+        }
+
         if (depth == Max_depth) // достигли глубины поиска
         {
-            return calc_score(mtx, (depth % 2 == color));
+            ++stats.leaves;
+            return calc_score(mtx, color);
+        }
+
+        // отсечение по расстоянию до конца партии: быстрее, чем здесь, не выиграть и не проиграть
+        const int win_here = SCORE_WIN - int(depth + 1);
+        if (optimization > 0 && x == -1)
+        {
+            alpha = max(alpha, -win_here);
+            beta = min(beta, win_here - 1);
+            if (alpha >= beta)
+                return alpha;
+        }
+
+        // таблица транспозиций: только для позиций в начале хода (не посреди серии взятий)
+        const bool use_tt = ((tt || persistent_tt) && x == -1);
+        const int remaining = int(Max_depth - depth);
+        const bool use_persistent = (use_tt && persistent_tt && remaining >= persistent_min_depth);
+        const uint64_t key = (use_tt ? tt_key(color) : 0);
+        Transposition_table::Entry entry;
+        bool have_entry = (use_tt && tt && tt->probe(key, entry));
+        stats.tt_probes += use_tt;
+        // в файле ищем, если в памяти нет записи нужной глубины
+        Transposition_table::Entry persistent_entry;
+        if (use_persistent && (!have_entry || entry.depth < remaining) &&
+            persistent_tt->probe(key, persistent_entry) && (!have_entry || persistent_entry.depth > entry.depth))
+        {
+            entry = persistent_entry;
+            have_entry = true;
+            ++stats.persistent_hits;
+        }
+        if (have_entry)
+        {
+            ++stats.tt_hits;
+            entry.score = score_from_tt(entry.score, depth + 1);
+            if (entry.depth >= remaining)
+            {
+                if (entry.bound == Transposition_table::BOUND_EXACT ||
+                    (entry.bound == Transposition_table::BOUND_LOWER && entry.score >= beta) ||
+                    (entry.bound == Transposition_table::BOUND_UPPER && entry.score <= alpha))
+                {
+                    ++stats.tt_cutoffs;
+                    if (recording)
+                        recording->tt_cutoff();
+                    return entry.score;
+                }
+            }
         }
 
         // если продолжаем серию взятий
@@ -171,130 +836,205 @@ private:
 
         if (!have_beats_now && x != -1)
         {
-            return find_best_turns_rec(mtx, 1 - color, depth + 1, alpha, beta);
+            return -find_best_turns_rec(mtx, 1 - color, depth + 1, -beta, -alpha);
         }
 
         if (turns.empty()) // если ходов нет — поражение
-            return (depth % 2 ? 0 : INF);
+            return -win_here;
+
+        // лучший ход из таблицы транспозиций проверяется первым
+        if (have_entry && !entry.move.empty())
+        {
+            for (size_t i = 1; i < turns_now.size(); ++i)
+            {
+                if (pack_move<Rules>(turns_now[i]) == entry.move)
+                {
+                    swap(turns_now[0], turns_now[i]);
+                    break;
+                }
+            }
+        }
 
-        double min_score = INF + 1;
-        double max_score = -1;
+        ++stats.expanded;
+        stats.moves += turns_now.size();
+        if (recording)
+            recording->expanded(turns_now.size());
+        const int alpha_before = alpha;
+        int best = -SCORE_INF;
+        int best_index = -1;
 
-        for (auto turn : turns_now)
+        for (size_t i = 0; i < turns_now.size(); ++i)
         {
-            double score = 0.0;
-            if (!have_beats_now && x == -1)
+            const auto turn = turns_now[i];
+            int score = 0;
+            push_turn(mtx, turn);
+            if ((!have_beats_now && x == -1) || ends_turn(mtx, turn))
             {
-                score = find_best_turns_rec(make_turn(mtx, turn), 1 - color, depth + 1, alpha, beta);
+                score = -find_best_turns_rec(make_turn(mtx, turn), 1 - color, depth + 1, -beta, -alpha);
             }
             else
             {
                 score = find_best_turns_rec(make_turn(mtx, turn), color, depth, alpha, beta, turn.x2, turn.y2);
             }
-
-            min_score = min(min_score, score);
-            max_score = max(max_score, score);
+            pop_turn();
+            if (aborted)
+                return 0;
+            if (score > best)
+            {
+                best = score;
+                update_pv(turn);
+                best_index = int(i);
+            }
 
             // альфа-бета отсечение
-            if (depth % 2)
-                alpha = max(alpha, max_score);
-            else
-                beta = min(beta, min_score);
+            alpha = max(alpha, best);
+            if (optimization > 0 && alpha >= beta)
+            {
+                ++stats.cutoffs;
+                stats.first_move_cutoffs += (i == 0);
+                if (recording)
+                    recording->cutoff(i);
+                break;
+            }
+        }
 
-            if (optimization != "O0" && alpha >= beta)
-                return (depth % 2 ? max_score + 1 : min_score - 1);
+        // возвращается найденное значение (fail-soft): при отсечении это честная граница оценки,
+        // поэтому её можно сохранить в таблицу транспозиций
+        if (use_tt)
+        {
+            auto bound = Transposition_table::BOUND_EXACT;
+            if (best >= beta)
+                bound = Transposition_table::BOUND_LOWER;
+            else if (best <= alpha_before)
+                bound = Transposition_table::BOUND_UPPER;
+            const Packed_move move = pack_move<Rules>(turns_now[best_index]);
+            const int stored = score_to_tt(best, depth + 1);
+            if (tt)
+                tt->store(key, stored, remaining, bound, move);
+            if (use_persistent)
+                persistent_tt->store(key, stored, remaining, bound, move);
         }
-        return (depth % 2 ? max_score : min_score);
+        return best;
     }
 
-public:
-    // Обёртки для поиска ходов
-    void find_turns(const bool color)
+    // В таблице выигрыш/проигрыш хранится от позиции записи (полуходов от неё до конца партии),
+    // в поиске — от корня: позиция может встретиться на разных расстояниях от корня
+    static int score_to_tt(const int score, const size_t from_root)
     {
-        find_turns(color, board->get_board());
+        if (score > SCORE_MAX_EVAL)
+            return score + int(from_root);
+        if (score < -SCORE_MAX_EVAL)
+            return score - int(from_root);
+        return score;
     }
 
-    void find_turns(const POS_T x, const POS_T y)
+    static int score_from_tt(const int score, const size_t from_root)
     {
-        find_turns(x, y, board->get_board());
+        if (score > SCORE_MAX_EVAL)
+            return score - int(from_root);
+        if (score < -SCORE_MAX_EVAL)
+            return score + int(from_root);
+        return score;
     }
 
-private:
+    // Ключ позиции на вершине пути поиска: расстановка и очередь хода (оценки хранятся для ходящего,
+    // поэтому записи общие для ботов обоих цветов)
+    uint64_t tt_key(const bool color) const
+    {
+        return hash_stack[ply] ^ Zobrist::get().side[color];
+    }
+
+public:
     // Поиск всех возможных ходов для заданного цвета
     // color = 0 (белые), 1 (чёрные)
     void find_turns(const bool color, const vector<vector<POS_T>>& mtx)
     {
         vector<move_pos> res_turns;   // список всех возможных ходов
+        vector<move_pos> piece_turns; // ходы одной фигуры
         bool have_beats_before = false; // флаг: есть ли обязательные взятия
 
         // перебираем все клетки доски
-        for (POS_T i = 0; i < 8; ++i)
+        for (POS_T i = 0; i < Rules::SIZE; ++i)
         {
-            for (POS_T j = 0; j < 8; ++j)
+            for (POS_T j = 0; j < Rules::SIZE; ++j)
             {
                 // если в клетке есть шашка нужного цвета
                 if (mtx[i][j] && mtx[i][j] % 2 != color)
                 {
                     // ищем ходы для этой шашки
-                    find_turns(i, j, mtx);
+                    const bool piece_beats = find_piece_turns(i, j, mtx, piece_turns);
 
                     // если нашли взятия — сбрасываем предыдущие ходы
-                    if (have_beats && !have_beats_before)
+                    if (piece_beats && !have_beats_before)
                     {
                         have_beats_before = true;
                         res_turns.clear();
                     }
 
                     // добавляем найденные ходы
-                    if ((have_beats_before && have_beats) || !have_beats_before)
+                    if ((have_beats_before && piece_beats) || !have_beats_before)
                     {
-                        res_turns.insert(res_turns.end(), turns.begin(), turns.end());
+                        res_turns.insert(res_turns.end(), piece_turns.begin(), piece_turns.end());
                     }
                 }
             }
         }
 
+        // правило большинства: остаются только начала серий, берущих больше всего фигур
+        if constexpr (Rules::MAJORITY_CAPTURE)
+        {
+            if (have_beats_before)
+                keep_longest(mtx, res_turns);
+        }
+
         // сохраняем результат
         turns = res_turns;
         shuffle(turns.begin(), turns.end(), rand_eng); // перемешиваем (если разрешено случайное поведение)
         have_beats = have_beats_before; // фиксируем, есть ли обязательные взятия
     }
 
-    // Поиск ходов для конкретной шашки (x,y)
+    // Поиск ходов для конкретной шашки (x,y) (в том числе продолжений серии взятий)
     void find_turns(const POS_T x, const POS_T y, const vector<vector<POS_T>>& mtx)
     {
-        turns.clear();
-        have_beats = false;
-        POS_T type = mtx[x][y]; // тип фигуры: 1/2 — шашки, 3/4 — дамки
+        have_beats = find_piece_turns(x, y, mtx, turns);
+        if constexpr (Rules::MAJORITY_CAPTURE)
+        {
+            if (have_beats)
+                keep_longest(mtx, turns);
+        }
+    }
+
+    // Заканчивается ли серия взятий ходом turn (на доске mtx до хода), даже если дальше можно бить:
+    // при Promotion_rule::ENDS_MOVE — когда шашка взятием дошла до дамочного поля
+    bool ends_turn(const vector<vector<POS_T>>& mtx, const move_pos& turn) const
+    {
+        if constexpr (Rules::PROMOTION == Promotion_rule::ENDS_MOVE)
+            return turn.xb != -1 && is_promotion_row<Rules>(mtx[turn.x][turn.y], turn.x2);
+        else
+            return false;
+    }
+
+  private:
+    // Ходы фигуры (x,y) в out; возвращает true, если это взятия (тогда они обязательны и других ходов нет)
+    bool find_piece_turns(const POS_T x, const POS_T y, const vector<vector<POS_T>>& mtx,
+        vector<move_pos>& out) const
+    {
+        out.clear();
+        const POS_T type = mtx[x][y]; // тип фигуры: 1/2 — шашки, 3/4 — дамки
+        const bool is_king = (type > 2);
+        const POS_T forward = ((type % 2) ? -1 : 1); // направление движения шашки
 
         // --- Проверка взятий ---
-        switch (type)
+        if (is_king && Rules::FLYING_KINGS)
         {
-        case 1: // белая шашка
-        case 2: // чёрная шашка
-            // проверяем возможные прыжки через соседние фигуры
-            for (POS_T i = x - 2; i <= x + 2; i += 4)
-            {
-                for (POS_T j = y - 2; j <= y + 2; j += 4)
-                {
-                    if (i < 0 || i > 7 || j < 0 || j > 7)
-                        continue;
-                    POS_T xb = (x + i) / 2, yb = (y + j) / 2; // координаты побитой шашки
-                    if (mtx[i][j] || !mtx[xb][yb] || mtx[xb][yb] % 2 == type % 2)
-                        continue;
-                    turns.emplace_back(x, y, i, j, xb, yb); // добавляем ход со взятием
-                }
-            }
-            break;
-
-        default: // дамка (3 или 4)
-            // проверяем взятия во всех диагональных направлениях
+            // дальнобойная дамка: взятия во всех диагональных направлениях
             for (POS_T i = -1; i <= 1; i += 2)
             {
                 for (POS_T j = -1; j <= 1; j += 2)
                 {
                     POS_T xb = -1, yb = -1;
-                    for (POS_T i2 = x + i, j2 = y + j; i2 != 8 && j2 != 8 && i2 != -1 && j2 != -1; i2 += i, j2 += j)
+                    for (POS_T i2 = x + i, j2 = y + j; i2 != Rules::SIZE && j2 != Rules::SIZE && i2 != -1 && j2 != -1;
+                         i2 += i, j2 += j)
                     {
                         if (mtx[i2][j2])
                         {
@@ -307,65 +1047,176 @@ private:
                         }
                         if (xb != -1 && xb != i2)
                         {
-                            turns.emplace_back(x, y, i2, j2, xb, yb);
+                            out.emplace_back(x, y, i2, j2, xb, yb);
                         }
                     }
                 }
             }
-            break;
         }
-
-        // если есть взятия — они обязательны
-        if (!turns.empty())
+        else
         {
-            have_beats = true;
-            return;
+            // шашка (и недальнобойная дамка): прыжок через соседнюю фигуру
+            for (POS_T di = -1; di <= 1; di += 2)
+            {
+                if (!is_king && !Rules::MEN_CAPTURE_BACKWARD && di != forward)
+                    continue;
+                for (POS_T dj = -1; dj <= 1; dj += 2)
+                {
+                    const POS_T i = x + 2 * di, j = y + 2 * dj;
+                    if (i < 0 || i >= Rules::SIZE || j < 0 || j >= Rules::SIZE)
+                        continue;
+                    const POS_T xb = x + di, yb = y + dj; // координаты побитой шашки
+                    if (mtx[i][j] || !mtx[xb][yb] || mtx[xb][yb] % 2 == type % 2)
+                        continue;
+                    out.emplace_back(x, y, i, j, xb, yb); // добавляем ход со взятием
+                }
+            }
         }
 
+        // если есть взятия — они обязательны
+        if (!out.empty())
+            return true;
+
         // --- Проверка обычных ходов ---
-        switch (type)
-        {
-        case 1: // белая шашка
-        case 2: // чёрная шашка
+        if (!is_king)
         {
-            POS_T i = ((type % 2) ? x - 1 : x + 1); // направление движения
+            const POS_T i = x + forward;
             for (POS_T j = y - 1; j <= y + 1; j += 2)
             {
-                if (i < 0 || i > 7 || j < 0 || j > 7 || mtx[i][j])
+                if (i < 0 || i >= Rules::SIZE || j < 0 || j >= Rules::SIZE || mtx[i][j])
                     continue;
-                turns.emplace_back(x, y, i, j); // добавляем обычный ход
+                out.emplace_back(x, y, i, j); // добавляем обычный ход
             }
-            break;
+            return false;
         }
-        default: // дамка
-            for (POS_T i = -1; i <= 1; i += 2)
+        for (POS_T i = -1; i <= 1; i += 2)
+        {
+            for (POS_T j = -1; j <= 1; j += 2)
             {
-                for (POS_T j = -1; j <= 1; j += 2)
+                for (POS_T i2 = x + i, j2 = y + j; i2 != Rules::SIZE && j2 != Rules::SIZE && i2 != -1 && j2 != -1;
+                     i2 += i, j2 += j)
                 {
-                    for (POS_T i2 = x + i, j2 = y + j; i2 != 8 && j2 != 8 && i2 != -1 && j2 != -1; i2 += i, j2 += j)
-                    {
-                        if (mtx[i2][j2])
-                            break;
-                        turns.emplace_back(x, y, i2, j2); // добавляем ход дамки
-                    }
+                    if (mtx[i2][j2])
+                        break;
+                    out.emplace_back(x, y, i2, j2); // добавляем ход дамки
+                    if (!Rules::FLYING_KINGS)
+                        break; // дамка ходит на одну клетку
                 }
             }
-            break;
         }
+        return false;
+    }
+
+    // Сколько фигур берёт самая длинная серия, начинающаяся взятием turn
+    int capture_length(const vector<vector<POS_T>>& mtx, const move_pos& turn) const
+    {
+        const auto next = make_turn(mtx, turn);
+        vector<move_pos> next_turns;
+        int longest = 0;
+        if (!ends_turn(mtx, turn) && find_piece_turns(turn.x2, turn.y2, next, next_turns))
+            for (const auto& next_turn : next_turns)
+                longest = max(longest, capture_length(next, next_turn));
+        return longest + 1;
+    }
+
+    // Правило большинства: из взятий list остаются начинающие самые длинные серии
+    void keep_longest(const vector<vector<POS_T>>& mtx, vector<move_pos>& list) const
+    {
+        vector<int> length(list.size());
+        int longest = 0;
+        for (size_t i = 0; i < list.size(); ++i)
+        {
+            length[i] = capture_length(mtx, list[i]);
+            longest = max(longest, length[i]);
+        }
+        size_t kept = 0;
+        for (size_t i = 0; i < list.size(); ++i)
+            if (length[i] == longest)
+                list[kept++] = list[i];
+        list.erase(list.begin() + kept, list.end());
+    }
+
+    // Может ли шашка, сделавшая взятие turn (на доске mtx до хода), бить дальше как шашка
+    bool man_can_capture(const vector<vector<POS_T>>& mtx, const move_pos& turn) const
+    {
+        const POS_T type = mtx[turn.x][turn.y];
+        // клетка после хода: начальная опустела, побитая тоже (или осталась до конца серии)
+        auto cell = [&](const POS_T i, const POS_T j) -> POS_T {
+            if (i == turn.xb && j == turn.yb)
+                return Rules::CAPTURED_STAY ? captured_marker(type) : 0;
+            return (i == turn.x && j == turn.y) ? 0 : mtx[i][j];
+        };
+        for (POS_T di = -1; di <= 1; di += 2)
+        {
+            if (!Rules::MEN_CAPTURE_BACKWARD && di != ((type % 2) ? -1 : 1))
+                continue;
+            for (POS_T dj = -1; dj <= 1; dj += 2)
+            {
+                const POS_T i = turn.x2 + 2 * di, j = turn.y2 + 2 * dj;
+                if (i < 0 || i >= Rules::SIZE || j < 0 || j >= Rules::SIZE)
+                    continue;
+                const POS_T xb = turn.x2 + di, yb = turn.y2 + dj;
+                if (!cell(i, j) && cell(xb, yb) && cell(xb, yb) % 2 != type % 2)
+                    return true;
+            }
+        }
+        return false;
     }
 
   public:
       vector<move_pos> turns; // список возможных ходов
       bool have_beats;        // есть ли обязательные взятия
       int Max_depth;          // максимальная глубина поиска minimax
+      int last_score = 0;     // оценка лучшего хода в последнем поиске для бота (Models/Search.h)
+
+      // Число узлов последнего поиска
+      long long get_nodes() const { return stats.nodes; }
 
   private:
       default_random_engine rand_eng; // генератор случайных чисел
       string scoring_mode;            // режим оценки (например, "NumberAndPotential")
-      string optimization;            // уровень оптимизации (O0, O1 и т.д.)
+      int optimization = 1;           // уровень оптимизации (Bot/Optimization "O<n>"; 0 — без отсечений)
+      string eval_source;             // режим оценки и файлы, из которых она загружена (для apply_settings)
       vector<move_pos> next_move;     // вспомогательный массив для восстановления лучшего хода
       vector<int> next_best_state;    // связи между состояниями для цепочек ходов
-      Board* board;                   // указатель на доску
       Config* config;                 // указатель на конфигурацию
+
+      Eval_params eval_params;        // параметры оценочной функции
+      double piece_score[5][Rules::SIZE][Rules::SIZE]; // вклад фигуры каждого типа на каждой клетке (из eval_params)
+
+      static const size_t NN_STACK_SIZE = 64;  // начальная глубина стека аккумуляторов (растёт при длинных взятиях)
+      shared_ptr<const NNUE> nn;               // веса нейросети (общие для копий Logic)
+      bool use_nn = false;                     // включена ли оценка нейросетью ("BotScoringType": "NN")
+      vector<NNUE::Accumulator> nn_stack;      // аккумуляторы по пути поиска: make = push, unmake = pop
+
+      size_t ply = 0;                          // число ходов от корня по текущему пути поиска
+      size_t depth_from_root = 0;              // полуходов от корня до позиции, которая сейчас оценивается
+      vector<vector<Packed_move>> pv_table = vector<vector<Packed_move>>(64); // главные варианты по ply
+      vector<uint64_t> hash_stack = vector<uint64_t>(64); // хеши расстановки по ply
+      vector<int> clock_stack = vector<int>(64); // полуходов с последнего необратимого хода по ply
+      vector<uint64_t> game_hashes;            // история партии до корня (set_history)
+      shared_ptr<Transposition_table> tt;      // таблица транспозиций (может быть общей для нескольких Logic)
+      shared_ptr<Persistent_table> persistent_tt; // таблица глубоких результатов в файле (PersistentTTPath)
+      shared_ptr<Search_recorder> recorder;    // запись дерева поиска (Log/SearchTree; копии Logic не ищут с ней)
+      Search_recorder* recording = nullptr;    // recorder на время итерации поиска
+      int persistent_min_depth = 0;            // минимальная оставшаяся глубина записей в файле
+      Level_type level_type = Level_type::DEPTH; // как задаётся уровень бота: глубина или бюджет узлов
+      long long level_nodes = 0;               // бюджет узлов уровня 0 при "LevelType": "Nodes"
+      long long node_budget = 0;               // бюджет узлов текущего уровня (0 — поиск на глубину Max_depth)
+      Search_stats stats;                      // статистика текущего поиска
+      size_t root_turns = 0;                   // число ходов в корне
+      Search_limits search_limits;             // ограничения текущего поиска
+      chrono::steady_clock::time_point search_start; // время начала поиска
+      bool can_abort = false;                  // можно ли прерывать текущую итерацию
+      bool aborted = false;                    // итерация прервана по ограничениям
 };
 
+// Русские шашки — правила игры с графикой
+using Logic = Logic_t<Russian_rules>;
+
+// В библиотеке checkers_engine Logic_t всех вариантов уже скомпилирован (Logic.cpp)
+#ifdef CHECKERS_ENGINE_LIBRARY
+extern template class Logic_t<Russian_rules>;
+extern template class Logic_t<English_rules>;
+extern template class Logic_t<International_rules>;
+#endif
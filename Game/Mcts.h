@@ -0,0 +1,569 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "../Models/Search.h"
+#include "../Models/Search_stats.h"
+#include "../Models/Settings.h"
+#include "Logic.h"
+
+// Поиск Монте-Карло по дереву (MCTS) — второй движок бота вместо альфа-беты Logic (Bot/WhiteBotEngine, BlackBotEngine).
+// Проход: спуск от корня по PUCT (Q + c * P * sqrt(N) / (1 + n)), раскрытие листа, его оценка — статической
+// оценкой Logic или случайной доигровкой (Bot/MctsLeaf) — и прибавление результата ко всем узлам пути.
+// Ребро дерева — один шаг: серия взятий — несколько рёбер подряд одного цвета. Позиция узла не хранится,
+// а восстанавливается шагами от корня; априорные вероятности детей P — softmax их статических оценок.
+// Потоки строят одно дерево без блокировок: счётчики узлов атомарные, незавершённый проход временно
+// считается проигрышем (виртуальный проигрыш), поэтому потоки расходятся по разным ветвям. Узел раскрывает
+// один поток, остальные до конца раскрытия оценивают его как лист.
+// Узлы берутся из пула фиксированного размера (Bot/MctsMemoryMB), дети узла лежат в пуле подряд; когда пул
+// кончился, дерево перестаёт расти, а проходы продолжаются по уже построенному. Между ходами
+// поддерево позиции, которая получилась на доске, сдвигается в начало пула, и поиск продолжается с него.
+// Ничья по повторению и по числу ходов поиском не учитывается.
+class Mcts
+{
+public:
+    // logic — образец генератора ходов и оценки (у каждого потока своя копия); bot — настройки Bot/Mcts*
+    Mcts(const Logic& logic, const Bot_settings& bot)
+        : logic(logic), exploration(bot.mcts_exploration), use_playouts(bot.mcts_playouts)
+    {
+        threads = (bot.mcts_threads > 0 ? bot.mcts_threads : int(max(1u, thread::hardware_concurrency())));
+        // на узел приходится и его место в таблице перенумерации при переносе поддерева
+        capacity = size_t(max(bot.mcts_memory_mb, 1)) * (1 << 20) / (sizeof(Node) + sizeof(uint32_t));
+        capacity = min<size_t>(max<size_t>(capacity, MIN_NODES), NONE - 1);
+        pool.reset(new Node[capacity]);
+        new_index.resize(capacity);
+    }
+
+    Mcts(const Mcts&) = delete;
+    Mcts& operator=(const Mcts&) = delete;
+
+    // Поиск хода цвета color в позиции mtx в пределах limits: время, число проходов (nodes), внешний флаг остановки.
+    // on_progress вызывается каждые PROGRESS_MS, как on_iteration у Logic::search (например, для Time_manager).
+    // Возвращает ход (серия взятий — несколько шагов); пустой — если ходов нет
+    vector<move_pos> search(const vector<vector<POS_T>>& mtx, const bool color, const Search_limits& limits,
+        const function<void(const Search_info&)>& on_progress = nullptr)
+    {
+        start = chrono::steady_clock::now();
+        stats = Mcts_stats();
+        stats.threads = threads;
+        playouts = 0;
+        max_depth = 0;
+        pool_full = false;
+        stop = false;
+
+        Logic local = logic;
+        reuse_tree(mtx, color);
+        if (pool[0].state.load() != EXPANDED && !expand(local, pool[0], mtx))
+        {
+            reset_tree(mtx, color); // перенесённое поддерево заняло весь пул
+            pool_full = false;
+            expand(local, pool[0], mtx);
+        }
+        stats.reused = min<long long>(used.load(), capacity);
+
+        const Node& root = pool[0];
+        last_score = 0;
+        if (root.child_count == 0)
+        {
+            finish_stats();
+            return {};
+        }
+        // единственный ход (не начало серии взятий) делается сразу
+        if (root.child_count > 1 || pool[root.first_child].chain)
+        {
+            const unsigned seed = unsigned(chrono::steady_clock::now().time_since_epoch().count());
+            vector<thread> workers;
+            for (int i = 0; i < threads; ++i)
+                workers.emplace_back(&Mcts::worker, this, seed + 7919u * unsigned(i));
+            long long next_report = PROGRESS_MS;
+            while (!stop)
+            {
+                this_thread::sleep_for(chrono::milliseconds(1));
+                const long long ms = elapsed_ms();
+                if ((limits.time_ms && ms >= limits.time_ms) || (limits.nodes && playouts >= limits.nodes) ||
+                    (limits.stop && *limits.stop))
+                    stop = true;
+                else if (on_progress && ms >= next_report)
+                {
+                    on_progress(make_info());
+                    next_report = ms + PROGRESS_MS;
+                }
+            }
+            for (auto& th : workers)
+                th.join();
+        }
+        last_score = child_score(pool[most_visited(root)]);
+        finish_stats();
+        return best_turn(local, mtx, color);
+    }
+
+    // Статистика последнего поиска
+    const Mcts_stats& get_stats() const
+    {
+        return stats;
+    }
+
+    int last_score = 0; // оценка лучшего хода в последнем поиске для бота (шкала Models/Search.h)
+
+private:
+    // Узел дерева (32 байта). Сумма результатов value — для стороны, сделавшей шаг в узел (то есть
+    // ходящей в родителе), в единицах 1 / VALUE_SCALE; visits включает проходы, которые ещё идут (in_flight)
+    struct Node
+    {
+        atomic<uint32_t> visits{ 0 };
+        atomic<int32_t> in_flight{ 0 };
+        atomic<int64_t> value{ 0 };
+        uint32_t first_child = 0;
+        uint16_t child_count = 0;
+        Packed_move move;   // шаг из родителя
+        float prior = 1;
+        atomic<uint8_t> state{ UNEXPANDED };
+        bool side = false;  // кто ходит в узле
+        bool chain = false; // серия взятий продолжается тем же цветом с клетки move.to()
+    };
+
+    enum : uint8_t
+    {
+        UNEXPANDED,
+        EXPANDING, // дети создаются (одним потоком)
+        EXPANDED
+    };
+
+    static const uint32_t NONE = UINT32_MAX;
+    static const size_t MIN_NODES = 1 << 12;
+    static constexpr double VALUE_SCALE = 1 << 16;
+    static constexpr double EVAL_SCALE = 1000;  // оценка Logic переводится в результат [-1, 1] как tanh(score / EVAL_SCALE)
+    static constexpr double PRIOR_SCALE = 100;  // «температура» softmax априорных вероятностей
+    static const int PLAYOUT_TURNS = 20;        // длина случайной доигровки в ходах, дальше — статическая оценка
+    static const int MAX_REUSE_TURNS = 2;       // на сколько ходов вперёд ищется новая позиция в старом дереве
+    static const long long PROGRESS_MS = 100;
+    static const size_t MAX_PV = 32;
+
+    void worker(const unsigned seed)
+    {
+        Logic local = logic;
+        local.set_seed(seed);
+        default_random_engine rng(seed);
+        vector<vector<POS_T>> mtx;
+        vector<uint32_t> path;
+        while (!stop.load(memory_order_relaxed))
+        {
+            mtx = root_board;
+            playout(local, rng, mtx, path);
+        }
+    }
+
+    // Один проход: спуск, раскрытие или оценка листа, обратное распространение
+    void playout(Logic& local, default_random_engine& rng, vector<vector<POS_T>>& mtx, vector<uint32_t>& path)
+    {
+        path.assign(1, 0);
+        pool[0].visits.fetch_add(1, memory_order_relaxed);
+        double result; // для стороны, которая ходит в последнем узле пути
+        while (true)
+        {
+            Node& node = pool[path.back()];
+            uint8_t state = node.state.load(memory_order_acquire);
+            if (state == UNEXPANDED && node.state.compare_exchange_strong(state, EXPANDING))
+            {
+                const bool ok = expand(local, node, mtx);
+                result = (ok && node.child_count == 0 ? -1 : leaf_value(local, rng, node, mtx));
+                break;
+            }
+            if (state != EXPANDED) // узел раскрывает другой поток
+            {
+                result = leaf_value(local, rng, node, mtx);
+                break;
+            }
+            if (node.child_count == 0) // ходов нет — проигрыш
+            {
+                result = -1;
+                break;
+            }
+            const uint32_t idx = select(node);
+            Node& child = pool[idx];
+            child.visits.fetch_add(1, memory_order_relaxed);
+            child.in_flight.fetch_add(1, memory_order_relaxed);
+            play(local, mtx, unpack_move<Russian_rules>(child.move, mtx));
+            path.push_back(idx);
+        }
+
+        const bool leaf_side = pool[path.back()].side;
+        const int64_t value = llround(result * VALUE_SCALE);
+        for (size_t i = path.size() - 1; i > 0; --i)
+        {
+            Node& node = pool[path[i]];
+            node.value.fetch_add(pool[path[i - 1]].side == leaf_side ? value : -value, memory_order_relaxed);
+            node.in_flight.fetch_sub(1, memory_order_relaxed);
+        }
+        playouts.fetch_add(1, memory_order_relaxed);
+        int depth = max_depth.load(memory_order_relaxed);
+        while (int(path.size()) - 1 > depth && !max_depth.compare_exchange_weak(depth, int(path.size()) - 1))
+        {
+        }
+    }
+
+    // Ребёнок с наибольшим Q + U; виртуальные проигрыши незавершённых проходов уменьшают Q
+    uint32_t select(const Node& node) const
+    {
+        const double sqrt_n = sqrt(double(max(node.visits.load(memory_order_relaxed), 1u)));
+        uint32_t best = node.first_child;
+        double best_score = -1e18;
+        for (uint32_t i = node.first_child; i < node.first_child + node.child_count; ++i)
+        {
+            const Node& child = pool[i];
+            const uint32_t n = child.visits.load(memory_order_relaxed);
+            const double q = n ? (child.value.load(memory_order_relaxed) / VALUE_SCALE -
+                                     child.in_flight.load(memory_order_relaxed)) / n
+                               : 0;
+            const double score = q + exploration * child.prior * sqrt_n / (1 + n);
+            if (score > best_score)
+            {
+                best_score = score;
+                best = i;
+            }
+        }
+        return best;
+    }
+
+    // Создание детей узла в позиции mtx; false — пул кончился (узел остаётся нераскрытым, дальше дерево
+    // не растёт, но проходы продолжают уточнять счётчики)
+    bool expand(Logic& local, Node& node, const vector<vector<POS_T>>& mtx)
+    {
+        if (pool_full.load(memory_order_relaxed))
+        {
+            node.state.store(UNEXPANDED, memory_order_release);
+            return false;
+        }
+        if (node.chain)
+            local.find_turns(rules_square_x<Russian_rules>(node.move.to()), rules_square_y<Russian_rules>(node.move.to()),
+                mtx);
+        else
+            local.find_turns(node.side, mtx);
+        const vector<move_pos> turns = local.turns;
+        const bool beats = local.have_beats;
+        if (turns.empty())
+        {
+            node.child_count = 0;
+            node.state.store(EXPANDED, memory_order_release);
+            return true;
+        }
+        const uint32_t first = used.fetch_add(uint32_t(turns.size()));
+        if (first + turns.size() > capacity)
+        {
+            pool_full = true;
+            node.state.store(UNEXPANDED, memory_order_release);
+            return false;
+        }
+
+        vector<double> logits(turns.size());
+        auto after = mtx;
+        for (size_t i = 0; i < turns.size(); ++i)
+        {
+            after = mtx;
+            play(local, after, turns[i]);
+            bool chain = false;
+            if (beats && !local.ends_turn(mtx, turns[i]))
+            {
+                local.find_turns(turns[i].x2, turns[i].y2, after);
+                chain = local.have_beats;
+            }
+            init_node(pool[first + i], pack_move<Russian_rules>(turns[i]), chain ? node.side : !node.side, chain);
+            logits[i] = local.evaluate(after, node.side) / PRIOR_SCALE;
+        }
+        const double max_logit = *max_element(logits.begin(), logits.end());
+        double sum = 0;
+        for (auto& logit : logits)
+            sum += (logit = exp(logit - max_logit));
+        for (size_t i = 0; i < turns.size(); ++i)
+            pool[first + i].prior = float(logits[i] / sum);
+
+        node.first_child = first;
+        node.child_count = uint16_t(turns.size());
+        node.state.store(EXPANDED, memory_order_release);
+        return true;
+    }
+
+    // Результат листа для ходящего в нём: статическая оценка или случайная доигровка (mtx портится)
+    double leaf_value(Logic& local, default_random_engine& rng, const Node& node, vector<vector<POS_T>>& mtx) const
+    {
+        if (!use_playouts)
+            return tanh(local.evaluate(mtx, node.side) / EVAL_SCALE);
+        if (node.chain)
+            random_chain(local, rng, mtx, rules_square_x<Russian_rules>(node.move.to()),
+                rules_square_y<Russian_rules>(node.move.to()));
+        bool side = node.side;
+        for (int turn_num = 0; turn_num < PLAYOUT_TURNS; ++turn_num, side = !side)
+        {
+            local.find_turns(side, mtx);
+            if (local.turns.empty())
+                return side == node.side ? -1 : 1;
+            const move_pos turn = local.turns[rng() % local.turns.size()];
+            const bool more = local.have_beats && !local.ends_turn(mtx, turn);
+            play(local, mtx, turn);
+            if (more)
+                random_chain(local, rng, mtx, turn.x2, turn.y2);
+        }
+        return tanh(local.evaluate(mtx, node.side) / EVAL_SCALE);
+    }
+
+    // Случайное продолжение серии взятий фигурой (x, y)
+    static void random_chain(Logic& local, default_random_engine& rng, vector<vector<POS_T>>& mtx, POS_T x, POS_T y)
+    {
+        while (true)
+        {
+            local.find_turns(x, y, mtx);
+            if (!local.have_beats)
+                return;
+            const move_pos turn = local.turns[rng() % local.turns.size()];
+            const bool ends = local.ends_turn(mtx, turn);
+            play(local, mtx, turn);
+            if (ends)
+                return;
+            x = turn.x2;
+            y = turn.y2;
+        }
+    }
+
+    // Шаг на доске mtx на месте (как Logic::make_turn без копии)
+    static void play(const Logic& local, vector<vector<POS_T>>& mtx, const move_pos& turn)
+    {
+        const POS_T type = local.moved_type(mtx, turn);
+        if (turn.xb != -1)
+            mtx[turn.xb][turn.yb] = 0;
+        mtx[turn.x2][turn.y2] = type;
+        mtx[turn.x][turn.y] = 0;
+    }
+
+    void init_node(Node& node, const Packed_move move, const bool side, const bool chain)
+    {
+        node.visits.store(0, memory_order_relaxed);
+        node.in_flight.store(0, memory_order_relaxed);
+        node.value.store(0, memory_order_relaxed);
+        node.first_child = 0;
+        node.child_count = 0;
+        node.move = move;
+        node.prior = 1;
+        node.state.store(UNEXPANDED, memory_order_relaxed);
+        node.side = side;
+        node.chain = chain;
+    }
+
+    // Самый посещённый ребёнок (при равенстве — с лучшим средним результатом)
+    uint32_t most_visited(const Node& node) const
+    {
+        uint32_t best = node.first_child;
+        for (uint32_t i = node.first_child + 1; i < node.first_child + node.child_count; ++i)
+        {
+            const uint32_t n = pool[i].visits.load(memory_order_relaxed), best_n = pool[best].visits.load(memory_order_relaxed);
+            if (n > best_n || (n == best_n && pool[i].value.load(memory_order_relaxed) > pool[best].value.load(memory_order_relaxed)))
+                best = i;
+        }
+        return best;
+    }
+
+    // Средний результат ребёнка, переведённый в шкалу оценок поиска
+    static int child_score(const Node& child)
+    {
+        const uint32_t n = child.visits.load(memory_order_relaxed);
+        if (!n)
+            return 0;
+        const double q = clamp(child.value.load(memory_order_relaxed) / VALUE_SCALE / n, -0.999, 0.999);
+        return int(clamp<long long>(llround(EVAL_SCALE * atanh(q)), -SCORE_MAX_EVAL, SCORE_MAX_EVAL));
+    }
+
+    // Промежуточный результат для on_progress: главный вариант по самым посещённым детям
+    Search_info make_info() const
+    {
+        Search_info info;
+        info.depth = max_depth;
+        info.nodes = playouts;
+        info.time_ms = elapsed_ms();
+        const Node& root = pool[0];
+        info.score = child_score(pool[most_visited(root)]);
+        auto board = root_board;
+        uint32_t idx = 0;
+        while (info.pv.size() < MAX_PV && pool[idx].state.load(memory_order_acquire) == EXPANDED &&
+               pool[idx].child_count)
+        {
+            idx = most_visited(pool[idx]);
+            if (!pool[idx].visits.load(memory_order_relaxed))
+                break;
+            info.pv.push_back(unpack_move<Russian_rules>(pool[idx].move, board));
+            play(logic, board, info.pv.back());
+        }
+        return info;
+    }
+
+    // Ход по самым посещённым детям корня; нераскрытое продолжение серии взятий доводится по статической оценке
+    vector<move_pos> best_turn(Logic& local, const vector<vector<POS_T>>& mtx, const bool color) const
+    {
+        vector<move_pos> res;
+        auto board = mtx;
+        uint32_t idx = 0;
+        while (pool[idx].state.load() == EXPANDED && pool[idx].child_count)
+        {
+            idx = most_visited(pool[idx]);
+            res.push_back(unpack_move<Russian_rules>(pool[idx].move, board));
+            play(local, board, res.back());
+            if (!pool[idx].chain)
+                return res;
+        }
+        while (!res.empty())
+        {
+            local.find_turns(res.back().x2, res.back().y2, board);
+            if (!local.have_beats)
+                break;
+            const vector<move_pos> turns = local.turns;
+            move_pos best = turns[0];
+            int best_score = -SCORE_INF;
+            for (const auto& turn : turns)
+            {
+                auto after = board;
+                play(local, after, turn);
+                const int score = local.evaluate(after, color);
+                if (score > best_score)
+                {
+                    best_score = score;
+                    best = turn;
+                }
+            }
+            const bool ends = local.ends_turn(board, best);
+            res.push_back(best);
+            play(local, board, best);
+            if (ends)
+                break;
+        }
+        return res;
+    }
+
+    // Корень для позиции mtx: поддерево прошлого поиска, если позиция в нём есть, иначе новое дерево
+    void reuse_tree(const vector<vector<POS_T>>& mtx, const bool color)
+    {
+        uint32_t found = NONE;
+        if (used.load())
+            found = (root_color == color && root_board == mtx ? 0 : find_node(0, root_board, 0, mtx, color));
+        if (found == NONE)
+            reset_tree(mtx, color);
+        else if (found != 0)
+            compact(found);
+        root_board = mtx;
+        root_color = color;
+    }
+
+    void reset_tree(const vector<vector<POS_T>>& mtx, const bool color)
+    {
+        init_node(pool[0], Packed_move(), color, false);
+        used = 1;
+        root_board = mtx;
+        root_color = color;
+    }
+
+    // Узел начала хода color в позиции mtx не дальше MAX_REUSE_TURNS ходов от узла idx (позиция board)
+    uint32_t find_node(const uint32_t idx, const vector<vector<POS_T>>& board, const int turns,
+        const vector<vector<POS_T>>& mtx, const bool color) const
+    {
+        const Node& node = pool[idx];
+        if (node.state.load() != EXPANDED)
+            return NONE;
+        for (uint32_t i = node.first_child; i < node.first_child + node.child_count; ++i)
+        {
+            const Node& child = pool[i];
+            auto after = board;
+            play(logic, after, unpack_move<Russian_rules>(child.move, board));
+            const bool new_turn = (child.side != node.side);
+            if (new_turn && child.side == color && after == mtx)
+                return i;
+            if (new_turn && turns + 1 >= MAX_REUSE_TURNS)
+                continue;
+            const uint32_t res = find_node(i, after, turns + new_turn, mtx, color);
+            if (res != NONE)
+                return res;
+        }
+        return NONE;
+    }
+
+    // Перенос поддерева узла new_root в начало пула. Узлы нумеруются заново по возрастанию старых номеров:
+    // новый номер не больше старого, поэтому узлы сдвигаются на месте, а братья остаются подряд
+    void compact(const uint32_t new_root)
+    {
+        const uint32_t size = uint32_t(min<size_t>(used.load(), capacity));
+        fill(new_index.begin(), new_index.begin() + size, NONE);
+        vector<uint32_t> stack(1, new_root);
+        while (!stack.empty())
+        {
+            const uint32_t idx = stack.back();
+            stack.pop_back();
+            new_index[idx] = 0;
+            const Node& node = pool[idx];
+            if (node.state.load() == EXPANDED)
+                for (uint32_t i = node.first_child; i < node.first_child + node.child_count; ++i)
+                    stack.push_back(i);
+        }
+        uint32_t kept = 0;
+        for (uint32_t i = new_root; i < size; ++i)
+            if (new_index[i] != NONE)
+                new_index[i] = kept++;
+        for (uint32_t i = new_root; i < size; ++i)
+        {
+            if (new_index[i] == NONE)
+                continue;
+            Node& dst = pool[new_index[i]];
+            const Node& src = pool[i];
+            const uint32_t first = src.first_child;
+            if (&dst != &src)
+            {
+                dst.visits.store(src.visits.load());
+                dst.in_flight.store(0);
+                dst.value.store(src.value.load());
+                dst.child_count = src.child_count;
+                dst.move = src.move;
+                dst.prior = src.prior;
+                dst.state.store(src.state.load());
+                dst.side = src.side;
+                dst.chain = src.chain;
+            }
+            dst.first_child = (dst.state.load() == EXPANDED && dst.child_count ? new_index[first] : 0);
+        }
+        used = kept;
+    }
+
+    void finish_stats()
+    {
+        stats.time_ms = elapsed_ms();
+        stats.playouts = playouts;
+        stats.tree_nodes = min<long long>(used.load(), capacity);
+        stats.max_depth = max_depth;
+        stats.pool_full = pool_full;
+    }
+
+    long long elapsed_ms() const
+    {
+        return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+    }
+
+    const Logic& logic;
+    int threads;
+    double exploration;  // Bot/MctsExploration — коэффициент c в PUCT
+    bool use_playouts;   // Bot/MctsLeaf: "Playout" — случайная доигровка, "Eval" — статическая оценка
+    size_t capacity;     // размер пула в узлах
+    unique_ptr<Node[]> pool;
+    vector<uint32_t> new_index; // перенумерация узлов при переносе поддерева
+    atomic<uint32_t> used{ 0 }; // занято узлов (при переполнении может стать немного больше capacity)
+    vector<vector<POS_T>> root_board;
+    bool root_color = false;
+
+    atomic<bool> stop{ false };
+    atomic<bool> pool_full{ false };
+    atomic<long long> playouts{ 0 };
+    atomic<int> max_depth{ 0 };
+    chrono::steady_clock::time_point start;
+    Mcts_stats stats;
+};
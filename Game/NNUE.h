@@ -0,0 +1,252 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+#include "../Models/Move.h"
+
+// Класс NNUE — маленькая квантованная нейросеть для оценки позиции.
+// Вход: 32 игровые клетки x 4 типа фигур (своя шашка, своя дамка, чужая шашка, чужая дамка) = 128 признаков.
+// Первый слой (int16) хранится в аккумуляторе и обновляется инкрементально при каждом ходе,
+// поэтому в листе остаётся посчитать только выходной слой (int8) — это несколько SIMD-инструкций.
+// Аккумулятор ведётся сразу для двух перспектив (белых и чёрных), сеть оценивает позицию
+// с точки зрения заданного цвета и возвращает логит вероятности его победы.
+class NNUE
+{
+public:
+    static const int N_INPUTS = 128;    // число входных признаков
+    static const int N_HIDDEN = 64;     // размер аккумулятора на одну перспективу (кратен 16 для AVX2)
+    static const int CLIP = 127;        // верхняя граница clipped ReLU после первого слоя
+    static const int OUTPUT_SCALE = 4096; // выход сети / OUTPUT_SCALE = логит вероятности победы
+    static const uint32_t VERSION = 1;
+
+    // Аккумулятор первого слоя для обеих перспектив + счётчики фигур (для быстрых проверок конца игры)
+    struct alignas(32) Accumulator
+    {
+        int16_t v[2][N_HIDDEN]; // [0] — с точки зрения белых, [1] — с точки зрения чёрных
+        int8_t pieces[2];       // количество фигур белых и чёрных
+    };
+
+    // Загрузка весов из бинарного файла.
+    // Формат (little-endian): "CKNN", uint32 версия, uint32 N_INPUTS, uint32 N_HIDDEN,
+    // int16 b1[N_HIDDEN], int16 w1[N_INPUTS][N_HIDDEN], int32 b2, int8 w2[2 * N_HIDDEN]
+    bool load(const std::string& path)
+    {
+        std::ifstream fin(path, std::ios::binary);
+        if (!fin)
+            return false;
+        char magic[4];
+        uint32_t version = 0, inputs = 0, hidden = 0;
+        fin.read(magic, 4);
+        fin.read(reinterpret_cast<char*>(&version), sizeof(version));
+        fin.read(reinterpret_cast<char*>(&inputs), sizeof(inputs));
+        fin.read(reinterpret_cast<char*>(&hidden), sizeof(hidden));
+        if (!fin || memcmp(magic, "CKNN", 4) != 0 || version != VERSION || inputs != N_INPUTS ||
+            hidden != N_HIDDEN)
+            return false;
+        fin.read(reinterpret_cast<char*>(b1), sizeof(b1));
+        fin.read(reinterpret_cast<char*>(w1), sizeof(w1));
+        fin.read(reinterpret_cast<char*>(&b2), sizeof(b2));
+        fin.read(reinterpret_cast<char*>(w2), sizeof(w2));
+        return bool(fin);
+    }
+
+    // Сохранение весов в том же формате (для внешних скриптов обучения)
+    bool save(const std::string& path) const
+    {
+        std::ofstream fout(path, std::ios::binary);
+        const uint32_t version = VERSION, inputs = N_INPUTS, hidden = N_HIDDEN;
+        fout.write("CKNN", 4);
+        fout.write(reinterpret_cast<const char*>(&version), sizeof(version));
+        fout.write(reinterpret_cast<const char*>(&inputs), sizeof(inputs));
+        fout.write(reinterpret_cast<const char*>(&hidden), sizeof(hidden));
+        fout.write(reinterpret_cast<const char*>(b1), sizeof(b1));
+        fout.write(reinterpret_cast<const char*>(w1), sizeof(w1));
+        fout.write(reinterpret_cast<const char*>(&b2), sizeof(b2));
+        fout.write(reinterpret_cast<const char*>(w2), sizeof(w2));
+        return bool(fout);
+    }
+
+    // Полный пересчёт аккумулятора по матрице доски (делается один раз в корне поиска)
+    void refresh(Accumulator& acc, const std::vector<std::vector<POS_T>>& mtx) const
+    {
+        for (int p = 0; p < 2; ++p)
+            memcpy(acc.v[p], b1, sizeof(b1));
+        acc.pieces[0] = acc.pieces[1] = 0;
+        for (POS_T i = 0; i < 8; ++i)
+        {
+            for (POS_T j = 0; j < 8; ++j)
+            {
+                if (mtx[i][j])
+                    add_piece(acc, mtx[i][j], i, j);
+            }
+        }
+    }
+
+    // Инкрементальное обновление: next = prev + ход turn, сделанный на доске mtx (до хода)
+    void update(const Accumulator& prev, Accumulator& next, const std::vector<std::vector<POS_T>>& mtx,
+        const move_pos& turn) const
+    {
+        next = prev;
+        POS_T type = mtx[turn.x][turn.y];
+        sub_piece(next, type, turn.x, turn.y);
+        if (turn.xb != -1)
+            sub_piece(next, mtx[turn.xb][turn.yb], turn.xb, turn.yb);
+        // превращение в дамку
+        if ((type == 1 && turn.x2 == 0) || (type == 2 && turn.x2 == 7))
+            type += 2;
+        add_piece(next, type, turn.x2, turn.y2);
+    }
+
+    // Оценка позиции с точки зрения цвета color (0 — белые, 1 — чёрные).
+    // Возвращает логит вероятности победы color, умноженный на OUTPUT_SCALE.
+    int32_t evaluate(const Accumulator& acc, const bool color) const
+    {
+        // своя перспектива идёт в первую половину входа выходного слоя, чужая — во вторую
+        return b2 + dot_clipped(acc.v[color], w2) + dot_clipped(acc.v[!color], w2 + N_HIDDEN);
+    }
+
+    // Отпечаток весов (FNV-1a), чтобы отличать одну сеть от другой
+    uint64_t checksum(uint64_t hash = 14695981039346656037ULL) const
+    {
+        auto mix = [&hash](const void* data, const size_t size) {
+            const unsigned char* bytes = static_cast<const unsigned char*>(data);
+            for (size_t i = 0; i < size; ++i)
+                hash = (hash ^ bytes[i]) * 1099511628211ULL;
+        };
+        mix(b1, sizeof(b1));
+        mix(w1, sizeof(w1));
+        mix(&b2, sizeof(b2));
+        mix(w2, sizeof(w2));
+        return hash;
+    }
+
+private:
+    // Индекс признака (фигура type на клетке (x, y)) с точки зрения перспективы persp
+    static int feature(const POS_T type, const POS_T x, const POS_T y, const int persp)
+    {
+        int sq = x * 4 + y / 2;            // номер игровой клетки 0..31
+        int owner = (type % 2 == 0);       // 0 — белая фигура, 1 — чёрная
+        int is_queen = (type > 2);
+        if (persp == 1)
+            sq = 31 - sq;                  // для чёрных доска разворачивается
+        int kind = (owner != persp) * 2 + is_queen;
+        return kind * 32 + sq;
+    }
+
+    void add_piece(Accumulator& acc, const POS_T type, const POS_T x, const POS_T y) const
+    {
+        for (int p = 0; p < 2; ++p)
+            add_column(acc.v[p], w1[feature(type, x, y, p)]);
+        ++acc.pieces[type % 2 == 0];
+    }
+
+    void sub_piece(Accumulator& acc, const POS_T type, const POS_T x, const POS_T y) const
+    {
+        for (int p = 0; p < 2; ++p)
+            sub_column(acc.v[p], w1[feature(type, x, y, p)]);
+        --acc.pieces[type % 2 == 0];
+    }
+
+    static void add_column(int16_t* acc, const int16_t* col)
+    {
+#if defined(__AVX2__)
+        for (int i = 0; i < N_HIDDEN; i += 16)
+        {
+            __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i*>(acc + i));
+            __m256i c = _mm256_load_si256(reinterpret_cast<const __m256i*>(col + i));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(acc + i), _mm256_add_epi16(a, c));
+        }
+#elif defined(__SSE2__) || defined(_M_X64)
+        for (int i = 0; i < N_HIDDEN; i += 8)
+        {
+            __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(acc + i));
+            __m128i c = _mm_load_si128(reinterpret_cast<const __m128i*>(col + i));
+            _mm_store_si128(reinterpret_cast<__m128i*>(acc + i), _mm_add_epi16(a, c));
+        }
+#else
+        for (int i = 0; i < N_HIDDEN; ++i)
+            acc[i] += col[i];
+#endif
+    }
+
+    static void sub_column(int16_t* acc, const int16_t* col)
+    {
+#if defined(__AVX2__)
+        for (int i = 0; i < N_HIDDEN; i += 16)
+        {
+            __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i*>(acc + i));
+            __m256i c = _mm256_load_si256(reinterpret_cast<const __m256i*>(col + i));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(acc + i), _mm256_sub_epi16(a, c));
+        }
+#elif defined(__SSE2__) || defined(_M_X64)
+        for (int i = 0; i < N_HIDDEN; i += 8)
+        {
+            __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(acc + i));
+            __m128i c = _mm_load_si128(reinterpret_cast<const __m128i*>(col + i));
+            _mm_store_si128(reinterpret_cast<__m128i*>(acc + i), _mm_sub_epi16(a, c));
+        }
+#else
+        for (int i = 0; i < N_HIDDEN; ++i)
+            acc[i] -= col[i];
+#endif
+    }
+
+    // Скалярное произведение clamp(acc, 0, CLIP) на веса выходного слоя
+    static int32_t dot_clipped(const int16_t* acc, const int8_t* w)
+    {
+#if defined(__AVX2__)
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i clip = _mm256_set1_epi16(CLIP);
+        __m256i sum = _mm256_setzero_si256();
+        for (int i = 0; i < N_HIDDEN; i += 16)
+        {
+            __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i*>(acc + i));
+            a = _mm256_min_epi16(_mm256_max_epi16(a, zero), clip);
+            __m256i wv = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(w + i)));
+            sum = _mm256_add_epi32(sum, _mm256_madd_epi16(a, wv));
+        }
+        __m128i s = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+        s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0x4E));
+        s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0xB1));
+        return _mm_cvtsi128_si32(s);
+#elif defined(__SSE2__) || defined(_M_X64)
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i clip = _mm_set1_epi16(CLIP);
+        __m128i sum = _mm_setzero_si128();
+        for (int i = 0; i < N_HIDDEN; i += 8)
+        {
+            __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(acc + i));
+            a = _mm_min_epi16(_mm_max_epi16(a, zero), clip);
+            __m128i w8 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(w + i));
+            __m128i wv = _mm_srai_epi16(_mm_unpacklo_epi8(w8, w8), 8); // расширение int8 -> int16 со знаком
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(a, wv));
+        }
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+        return _mm_cvtsi128_si32(sum);
+#else
+        int32_t sum = 0;
+        for (int i = 0; i < N_HIDDEN; ++i)
+        {
+            int32_t a = acc[i] < 0 ? 0 : (acc[i] > CLIP ? CLIP : acc[i]);
+            sum += a * w[i];
+        }
+        return sum;
+#endif
+    }
+
+public:
+    alignas(32) int16_t b1[N_HIDDEN] = {};           // смещения первого слоя
+    alignas(32) int16_t w1[N_INPUTS][N_HIDDEN] = {}; // веса первого слоя (столбец на каждый признак)
+    int32_t b2 = 0;                                  // смещение выхода
+    alignas(32) int8_t w2[2 * N_HIDDEN] = {};        // веса выходного слоя
+};
@@ -0,0 +1,264 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "Transposition_table.h"
+
+// Таблица результатов глубокого поиска в файле, отображённом в память (переживает перезапуск партии и программы).
+// Записи в том же формате, что и в Transposition_table (ключ XOR данные), поэтому файл можно одновременно
+// читать и дополнять из нескольких потоков и процессов без блокировок: наполовину записанная запись
+// просто не найдётся. Пока таблица открыта, на файл держится разделяемая блокировка.
+// Заголовок хранит версию формата и отпечаток функции оценки: если оценка изменилась (другой режим,
+// параметры или веса сети), старые записи неверны и таблица очищается — но только под исключительной
+// блокировкой, то есть когда файл больше никто не держит открытым. Иначе open не удаётся (поиск идёт
+// без файловой таблицы): процессы со старой оценкой продолжали бы читать и писать очищенные записи.
+class Persistent_table
+{
+public:
+    static const uint32_t VERSION = 3; // 2 — целые оценки для ходящей стороны, 3 — ход в Packed_move
+
+    Persistent_table() = default;
+    Persistent_table(const Persistent_table&) = delete;
+    Persistent_table& operator=(const Persistent_table&) = delete;
+
+    ~Persistent_table()
+    {
+        close();
+    }
+
+    // Открытие (или создание) файла path на size_mb мегабайт. Если файл уже есть с тем же форматом,
+    // берётся его размер. eval_hash — отпечаток функции оценки. Возвращает false при ошибке
+    // и когда таблицу с другой оценкой или форматом держит открытой другой процесс (или другой Logic).
+    bool open(const std::string& path, const size_t size_mb, const uint64_t eval_hash)
+    {
+        close();
+        size_t count = 1;
+        while (count * 2 * SLOT_BYTES <= size_mb * (1 << 20))
+            count *= 2;
+        if (!map_file(path, sizeof(Header) + count * SLOT_BYTES))
+            return false;
+
+        lock_file(SHARED); // ждёт, пока другой процесс очищает таблицу
+        Header* header = reinterpret_cast<Header*>(base);
+        if (!matches(eval_hash))
+        {
+            // новый файл, другой формат или другая оценка — начинаем с пустой таблицы, если файл больше никем
+            // не открыт; после смены блокировки заголовок проверяется снова: его мог обновить другой процесс
+            if (!lock_file(EXCLUSIVE_NOWAIT))
+            {
+                close();
+                return false;
+            }
+            if (!matches(eval_hash))
+            {
+                const size_t capacity = (mapped_size - sizeof(Header)) / SLOT_BYTES;
+                while (count > capacity)
+                    count /= 2;
+                memset(base + sizeof(Header), 0, count * SLOT_BYTES);
+                memcpy(header->magic, MAGIC, 4);
+                header->version = VERSION;
+                header->slot_count = count;
+                header->eval_hash = eval_hash;
+                flush();
+            }
+            lock_file(SHARED);
+            if (!matches(eval_hash)) // пока блокировка менялась, таблицу очистил процесс с другой оценкой
+            {
+                close();
+                return false;
+            }
+        }
+        count = size_t(header->slot_count);
+        slots = reinterpret_cast<std::atomic<uint64_t>*>(base + sizeof(Header));
+        mask = count - 1;
+        return true;
+    }
+
+    bool is_open() const
+    {
+        return slots != nullptr;
+    }
+
+    bool probe(const uint64_t key, Transposition_table::Entry& entry) const
+    {
+        const std::atomic<uint64_t>* slot = slots + 2 * (key & mask);
+        const uint64_t data = slot[1].load(std::memory_order_relaxed);
+        if ((slot[0].load(std::memory_order_relaxed) ^ data) != key || data == 0)
+            return false;
+        entry = Transposition_table::unpack(data);
+        return true;
+    }
+
+    // Замещаются пустые и менее глубокие записи, а также запись той же позиции
+    void store(const uint64_t key, const int score, const int depth, const Transposition_table::Bound bound,
+        const Packed_move move)
+    {
+        std::atomic<uint64_t>* slot = slots + 2 * (key & mask);
+        const uint64_t old = slot[1].load(std::memory_order_relaxed);
+        const bool same = ((slot[0].load(std::memory_order_relaxed) ^ old) == key);
+        if (old && !same && int((old >> 32) & 255) > depth)
+            return;
+        const uint64_t data = Transposition_table::pack(score, depth, bound, move, 1);
+        slot[0].store(key ^ data, std::memory_order_relaxed);
+        slot[1].store(data, std::memory_order_relaxed);
+    }
+
+    // Сброс изменённых страниц на диск (иначе это делает ОС в фоне и при закрытии)
+    void flush()
+    {
+#ifdef _WIN32
+        if (base)
+            FlushViewOfFile(base, 0);
+#else
+        if (base)
+            msync(base, mapped_size, MS_ASYNC);
+#endif
+    }
+
+    void close()
+    {
+        if (!base)
+            return;
+        flush();
+#ifdef _WIN32
+        UnmapViewOfFile(base);
+        CloseHandle(mapping);
+        CloseHandle(file);
+        mapping = file = nullptr;
+#else
+        munmap(base, mapped_size);
+        ::close(fd);
+        fd = -1;
+#endif
+        base = nullptr;
+        slots = nullptr;
+        mapped_size = 0;
+    }
+
+    // FNV-1a: отпечаток функции оценки для заголовка
+    static uint64_t fingerprint(const void* data, const size_t size, uint64_t hash = 14695981039346656037ULL)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i)
+            hash = (hash ^ bytes[i]) * 1099511628211ULL;
+        return hash;
+    }
+
+private:
+    static constexpr const char* MAGIC = "CKPT";
+    static const size_t SLOT_BYTES = 2 * sizeof(uint64_t);
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared table needs lock-free 64-bit atomics");
+
+    struct Header
+    {
+        char magic[4];
+        uint32_t version;
+        uint64_t slot_count;
+        uint64_t eval_hash;
+        uint64_t reserved[5]; // заголовок занимает 64 байта, записи выровнены по строке кэша
+    };
+
+    // Заголовок правильный и записан для оценки eval_hash
+    bool matches(const uint64_t eval_hash) const
+    {
+        const Header* header = reinterpret_cast<const Header*>(base);
+        return memcmp(header->magic, MAGIC, 4) == 0 && header->version == VERSION && header->slot_count &&
+               (header->slot_count & (header->slot_count - 1)) == 0 &&
+               sizeof(Header) + header->slot_count * SLOT_BYTES <= mapped_size && header->eval_hash == eval_hash;
+    }
+
+    // Файл расширяется до нужного размера (но не уменьшается: его может держать открытым другой процесс)
+    bool map_file(const std::string& path, const size_t size)
+    {
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+            OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            file = nullptr;
+            return false;
+        }
+        LARGE_INTEGER cur;
+        GetFileSizeEx(file, &cur);
+        const size_t total = std::max(size, size_t(cur.QuadPart));
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, DWORD(uint64_t(total) >> 32), DWORD(total), nullptr);
+        base = mapping ? static_cast<char*>(MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, total)) : nullptr;
+        if (!base)
+        {
+            if (mapping)
+                CloseHandle(mapping);
+            CloseHandle(file);
+            mapping = file = nullptr;
+            return false;
+        }
+#else
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd < 0)
+            return false;
+        struct stat st;
+        fstat(fd, &st);
+        const size_t total = std::max(size, size_t(st.st_size));
+        void* addr = MAP_FAILED;
+        if (size_t(st.st_size) >= total || ftruncate(fd, off_t(total)) == 0)
+            addr = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (addr == MAP_FAILED)
+        {
+            ::close(fd);
+            fd = -1;
+            return false;
+        }
+        base = static_cast<char*>(addr);
+#endif
+        mapped_size = total;
+        return true;
+    }
+
+    enum Lock
+    {
+        SHARED,          // таблица открыта (ждёт снятия исключительной блокировки)
+        EXCLUSIVE_NOWAIT // очистка таблицы: не удаётся, если файл держит кто-то ещё
+    };
+
+    // Смена блокировки файла (закрытие файла её снимает)
+    bool lock_file(const Lock lock)
+    {
+#ifdef _WIN32
+        OVERLAPPED ov = {};
+        UnlockFileEx(file, 0, sizeof(Header), 0, &ov); // без блокировки — просто ошибка
+        const DWORD flags = (lock == SHARED ? 0 : LOCKFILE_EXCLUSIVE_LOCK | LOCKFILE_FAIL_IMMEDIATELY);
+        return LockFileEx(file, flags, 0, sizeof(Header), 0, &ov) != 0;
+#else
+        return flock(fd, lock == SHARED ? LOCK_SH : LOCK_EX | LOCK_NB) == 0;
+#endif
+    }
+
+#ifdef _WIN32
+    HANDLE file = nullptr;
+    HANDLE mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+    char* base = nullptr;
+    size_t mapped_size = 0;
+    std::atomic<uint64_t>* slots = nullptr;
+    size_t mask = 0;
+};
@@ -0,0 +1,381 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "Logic.h"
+#include "Zobrist.h"
+
+// Решатель окончаний поиском по числам доказательства (df-pn — в глубину, с порогами).
+// Доказывает или опровергает форсированный выигрыш стороны attacker: в узлах её хода достаточно одного
+// выигрывающего хода (OR), в узлах соперника выигрыш нужен после любого ответа (AND). У каждого узла два числа:
+// pn — сколько ещё листьев надо доказать, dn — сколько опровергнуть; поиск всегда идёт в самый
+// «дешёвый» узел и возвращается, когда его числа превышают пороги родителя.
+// Память ограничена: числа хранятся в таблице фиксированного размера из пар записей — в первой остаётся
+// позиция с большей работой, во вторую пишется последняя; вытесненное пересчитывается.
+// Ничья (повторение на пути, длина пути > MAX_PLY) считается «не выигрыш»: такие опровержения зависят
+// от пути, но доказательства от них не зависят — найденный выигрыш верен всегда, а «не выигрыш»
+// означает лишь, что выигрыша не нашлось.
+class Pn_solver
+{
+public:
+    enum Result
+    {
+        WIN,    // выигрыш доказан
+        NO_WIN, // выигрыша нет (проигрыш или ничья)
+        UNKNOWN // не хватило бюджета узлов
+    };
+
+    struct Solution
+    {
+        Result result = UNKNOWN;
+        vector<vector<move_pos>> line; // при WIN — выигрывающий вариант: полные ходы (серии взятий) по очереди
+        int distance = 0;              // при WIN — не больше стольких полных ходов до выигрыша
+        long long nodes = 0;
+        long long time_ms = 0;
+    };
+
+    // logic — генератор ходов; table_mb — размер таблицы чисел доказательства
+    Pn_solver(Logic& logic, const size_t table_mb) : logic(logic)
+    {
+        size_t count = 1;
+        while (count * 4 * sizeof(Entry) <= max<size_t>(table_mb, 1) * (1 << 20))
+            count *= 2;
+        table.resize(2 * count);
+        mask = count - 1;
+    }
+
+    // Доказательство выигрыша стороны color в позиции mtx (ход color) не больше чем за max_nodes узлов.
+    // stop — внешний флаг прерывания (результат тогда UNKNOWN)
+    Solution solve(const vector<vector<POS_T>>& mtx, const bool color, const long long max_nodes,
+        const atomic<bool>* stop = nullptr)
+    {
+        auto start = chrono::steady_clock::now();
+        fill(table.begin(), table.end(), Entry());
+        attacker = color;
+        node_limit = max_nodes;
+        stop_flag = stop;
+        nodes = 0;
+        clear_path();
+
+        const uint64_t root = key(mtx, color);
+        mid(mtx, color, root, PN_INF, PN_INF);
+
+        Solution res;
+        const Entry* entry = probe(root);
+        if (entry && entry->pn == 0)
+        {
+            res.result = WIN;
+            res.distance = entry->distance;
+            res.line = winning_line(mtx, color);
+        }
+        else if (entry && entry->dn == 0)
+            res.result = NO_WIN;
+        res.nodes = nodes;
+        res.time_ms = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+        return res;
+    }
+
+    // Число фигур на доске (решатель включается в окончаниях)
+    static int count_pieces(const vector<vector<POS_T>>& mtx)
+    {
+        int count = 0;
+        for (const auto& row : mtx)
+            for (POS_T cell : row)
+                count += (cell != 0);
+        return count;
+    }
+
+private:
+    static const uint32_t PN_INF = 100000000; // доказано/опровергнуто
+    static const size_t MAX_PLY = 200;        // более длинный путь считается ничьей
+
+    struct Entry
+    {
+        uint64_t key = 0;
+        uint32_t pn = 1, dn = 1;
+        uint32_t work = 0;    // узлов, потраченных на позицию (приоритет при замещении)
+        uint32_t distance = 0; // при pn == 0 — полных ходов до выигрыша по найденному доказательству
+    };
+
+    struct Child
+    {
+        vector<move_pos> turns;
+        vector<vector<POS_T>> mtx;
+        uint64_t key;
+    };
+
+    uint64_t key(const vector<vector<POS_T>>& mtx, const bool color) const
+    {
+        const Zobrist& zobrist = Zobrist::get();
+        return zobrist.board_hash(mtx) ^ zobrist.side[color] ^ zobrist.bot[attacker];
+    }
+
+    const Entry* probe(const uint64_t key) const
+    {
+        const Entry* bucket = &table[2 * (key & mask)];
+        for (int i = 0; i < 2; ++i)
+            if (bucket[i].key == key)
+                return &bucket[i];
+        return nullptr;
+    }
+
+    void store(const uint64_t key, const uint32_t pn, const uint32_t dn, const long long work, const uint32_t distance)
+    {
+        Entry* bucket = &table[2 * (key & mask)];
+        const uint32_t work32 = uint32_t(min<long long>(work, UINT32_MAX));
+        // запись позиции — на её прежнем месте; новая дороже первой записи — вытесняет её во вторую
+        Entry* entry = &bucket[0];
+        if (bucket[1].key == key)
+            entry = &bucket[1];
+        else if (bucket[0].key != key)
+        {
+            if (bucket[0].work > work32)
+                entry = &bucket[1];
+            else
+                bucket[1] = bucket[0];
+        }
+        entry->key = key;
+        entry->pn = pn;
+        entry->dn = dn;
+        entry->work = work32;
+        entry->distance = distance;
+    }
+
+    // Сложение чисел с насыщением: сумма остаётся меньше PN_INF (иначе недоказанный узел
+    // из-за переполнения считался бы решённым)
+    static uint32_t add(const uint64_t a, const uint64_t b)
+    {
+        return uint32_t(min<uint64_t>(a + b, PN_INF - 1));
+    }
+
+    void push_path(const uint64_t key)
+    {
+        path.push_back(key);
+        ++path_filter[key & (PATH_FILTER_SIZE - 1)];
+    }
+
+    void pop_path()
+    {
+        --path_filter[path.back() & (PATH_FILTER_SIZE - 1)];
+        path.pop_back();
+    }
+
+    void clear_path()
+    {
+        path.clear();
+        fill(path_filter.begin(), path_filter.end(), 0);
+    }
+
+    bool on_path(const uint64_t key) const
+    {
+        return path_filter[key & (PATH_FILTER_SIZE - 1)] && find(path.begin(), path.end(), key) != path.end();
+    }
+
+    // Все полные ходы позиции (серии взятий развёрнуты до конца) и позиции после них
+    void expand(const vector<vector<POS_T>>& mtx, const bool color, vector<Child>& out, vector<move_pos>& chain,
+        const POS_T x = -1, const POS_T y = -1)
+    {
+        if (x == -1)
+            logic.find_turns(color, mtx);
+        else
+            logic.find_turns(x, y, mtx);
+        if (x != -1 && !logic.have_beats) // серия взятий закончилась
+        {
+            out.push_back({ chain, mtx, key(mtx, !color) });
+            return;
+        }
+        const auto turns_now = logic.turns;
+        const bool have_beats_now = logic.have_beats;
+        for (const auto& turn : turns_now)
+        {
+            chain.push_back(turn);
+            auto next = logic.make_turn(mtx, turn);
+            if (have_beats_now && !logic.ends_turn(mtx, turn))
+                expand(next, color, out, chain, turn.x2, turn.y2);
+            else
+                out.push_back({ chain, next, key(next, !color) });
+            chain.pop_back();
+        }
+    }
+
+    // Числа потомка: из таблицы; повторение позиции на пути — ничья, то есть «не выигрыш»
+    void child_numbers(const Child& child, uint32_t& pn, uint32_t& dn, uint32_t& distance) const
+    {
+        distance = 0;
+        if (on_path(child.key))
+        {
+            pn = PN_INF;
+            dn = 0;
+            return;
+        }
+        const Entry* entry = probe(child.key);
+        pn = (entry ? entry->pn : 1);
+        dn = (entry ? entry->dn : 1);
+        if (entry)
+            distance = entry->distance;
+    }
+
+    bool out_of_limits() const
+    {
+        return nodes >= node_limit || (stop_flag && stop_flag->load(memory_order_relaxed));
+    }
+
+    // Поиск из узла, пока его числа не достигнут порогов thpn/thdn; результат — в таблице
+    void mid(const vector<vector<POS_T>>& mtx, const bool color, const uint64_t node_key, const uint32_t thpn,
+        const uint32_t thdn)
+    {
+        ++nodes;
+        const long long nodes_before = nodes;
+        const bool or_node = (color == attacker);
+        vector<Child> children;
+        vector<move_pos> chain;
+        expand(mtx, color, children, chain);
+        if (children.empty()) // ходов нет — сторона, которая ходит, проиграла
+        {
+            store(node_key, or_node ? PN_INF : 0, or_node ? 0 : PN_INF, 1, 0);
+            return;
+        }
+        if (path.size() >= MAX_PLY)
+        {
+            store(node_key, PN_INF, 0, 1, 0);
+            return;
+        }
+
+        push_path(node_key);
+        while (true)
+        {
+            // числа узла: в OR — минимум pn потомков и «слабая сумма» dn (максимум + число остальных
+            // нерешённых потомков), в AND — наоборот. Настоящая сумма на переходах и циклах учитывает
+            // одни и те же узлы многократно и быстро переполняется
+            uint32_t pn = (or_node ? PN_INF : 0), dn = (or_node ? 0 : PN_INF);
+            uint32_t open = 0; // потомков с ненулевым суммируемым числом
+            uint32_t best_value = PN_INF, second_value = PN_INF; // выбираемое число лучшего и второго потомка
+            uint32_t distance = (or_node ? UINT32_MAX : 0);
+            size_t best = 0;
+            uint32_t best_pn = 1, best_dn = 1;
+            for (size_t i = 0; i < children.size(); ++i)
+            {
+                uint32_t c_pn, c_dn, c_distance;
+                child_numbers(children[i], c_pn, c_dn, c_distance);
+                if (or_node)
+                {
+                    pn = min(pn, c_pn);
+                    dn = max(dn, c_dn);
+                    open += (c_dn != 0);
+                    if (c_pn == 0)
+                        distance = min(distance, c_distance + 1);
+                }
+                else
+                {
+                    pn = max(pn, c_pn);
+                    dn = min(dn, c_dn);
+                    open += (c_pn != 0);
+                    distance = max(distance, c_distance + 1);
+                }
+                const uint32_t value = (or_node ? c_pn : c_dn);
+                if (value < best_value)
+                {
+                    second_value = best_value;
+                    best_value = value;
+                    best = i;
+                    best_pn = c_pn;
+                    best_dn = c_dn;
+                }
+                else if (value < second_value)
+                    second_value = value;
+            }
+            if (or_node && dn)
+                dn = add(dn, open - 1);
+            if (!or_node && pn)
+                pn = add(pn, open - 1);
+            if (pn == 0) // доказан
+                dn = PN_INF;
+            else if (dn == 0) // опровергнут
+                pn = PN_INF;
+            if (pn >= thpn || dn >= thdn || out_of_limits())
+            {
+                store(node_key, pn, dn, nodes - nodes_before + 1, pn == 0 ? distance : 0);
+                break;
+            }
+            // пороги потомка: он остаётся лучшим, пока его число не превысит число второго
+            uint32_t c_thpn, c_thdn;
+            if (or_node)
+            {
+                c_thpn = min<uint32_t>(thpn, add(second_value, second_value / 4 + 1));
+                c_thdn = add(uint64_t(thdn) - dn, best_dn);
+            }
+            else
+            {
+                c_thdn = min<uint32_t>(thdn, add(second_value, second_value / 4 + 1));
+                c_thpn = add(uint64_t(thpn) - pn, best_pn);
+            }
+            const Child& child = children[best];
+            mid(child.mtx, !color, child.key, c_thpn, c_thdn);
+        }
+        pop_path();
+    }
+
+    // Выигрывающий вариант по таблице: сторона attacker выбирает самый быстрый доказанный ход,
+    // соперник — самое долгое сопротивление. Если доказательство позиции вытеснено из таблицы,
+    // оно ищется заново в пределах оставшегося бюджета узлов, иначе вариант обрывается
+    vector<vector<move_pos>> winning_line(vector<vector<POS_T>> mtx, bool color)
+    {
+        vector<vector<move_pos>> line;
+        clear_path();
+        for (size_t ply = 0; ply < MAX_PLY; ++ply)
+        {
+            vector<Child> children;
+            vector<move_pos> chain;
+            expand(mtx, color, children, chain);
+            if (children.empty())
+                break;
+            const uint64_t node_key = key(mtx, color);
+            const Child* next = proven_child(children, color);
+            if (!next && !out_of_limits())
+            {
+                mid(mtx, color, node_key, PN_INF, PN_INF);
+                next = proven_child(children, color);
+            }
+            if (!next)
+                break;
+            push_path(node_key);
+            line.push_back(next->turns);
+            mtx = next->mtx;
+            color = !color;
+        }
+        return line;
+    }
+
+    // Доказанный потомок для варианта: у attacker — ближайший выигрыш, у соперника — самый дальний
+    const Child* proven_child(const vector<Child>& children, const bool color) const
+    {
+        const Child* next = nullptr;
+        uint32_t next_distance = 0;
+        for (const auto& child : children)
+        {
+            uint32_t pn, dn, distance;
+            child_numbers(child, pn, dn, distance);
+            if (pn != 0)
+                continue;
+            if (!next || (color == attacker ? distance < next_distance : distance > next_distance))
+            {
+                next = &child;
+                next_distance = distance;
+            }
+        }
+        return next;
+    }
+
+    Logic& logic;
+    vector<Entry> table;
+    size_t mask = 0;
+    static const size_t PATH_FILTER_SIZE = 4096;
+    vector<uint64_t> path; // ключи позиций на текущем пути (повторения)
+    vector<uint8_t> path_filter = vector<uint8_t>(PATH_FILTER_SIZE); // счётчики ключей пути по младшим битам
+    bool attacker = false; // сторона, выигрыш которой доказывается
+    long long nodes = 0;
+    long long node_limit = 0;
+    const atomic<bool>* stop_flag = nullptr;
+};
@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "../Models/Move.h"
+#include "Zobrist.h"
+
+// История позиций партии в начале каждого хода: для ничьей по повторению и по отсутствию прогресса.
+// Необратимый ход — взятие или ход простой шашкой: после него ни одна из прежних позиций повториться не может,
+// поэтому повторения ищутся только среди позиций после последнего такого хода.
+class Position_history
+{
+public:
+    void clear()
+    {
+        hashes.clear();
+        men.clear();
+        clock.clear();
+    }
+
+    // Позиция mtx в начале хода number (0, 1, ...). Более поздние ходы забываются (откат хода)
+    void set(const size_t number, const std::vector<std::vector<POS_T>>& mtx)
+    {
+        hashes.resize(number);
+        men.resize(number);
+        clock.resize(number);
+        const uint64_t men_hash = men_key(mtx);
+        hashes.push_back(Zobrist::get().board_hash(mtx));
+        clock.push_back(number > 0 && men.back() == men_hash ? clock.back() + 1 : 0);
+        men.push_back(men_hash);
+    }
+
+    // Сколько раз текущая позиция встречалась в партии с той же очередью хода (включая текущую)
+    int repetitions() const
+    {
+        if (hashes.empty())
+            return 0;
+        int count = 1;
+        const size_t cur = hashes.size() - 1;
+        for (size_t back = 2; back <= size_t(clock.back()); back += 2)
+            count += (hashes[cur - back] == hashes[cur]);
+        return count;
+    }
+
+    // Полуходов подряд без взятий и ходов простыми шашками
+    int no_progress() const
+    {
+        return clock.empty() ? 0 : clock.back();
+    }
+
+    // Хеши расстановки предыдущих позиций после последнего необратимого хода, от старых к новым
+    // (история партии для поиска, см. Logic::set_history)
+    std::vector<uint64_t> reversible_hashes() const
+    {
+        if (hashes.empty())
+            return {};
+        return std::vector<uint64_t>(hashes.end() - 1 - clock.back(), hashes.end() - 1);
+    }
+
+private:
+    // Расстановка простых шашек и число фигур: меняются только при необратимом ходе
+    static uint64_t men_key(const std::vector<std::vector<POS_T>>& mtx)
+    {
+        const Zobrist& zobrist = Zobrist::get();
+        uint64_t key = 0;
+        for (int sq = 0; sq < 32; ++sq)
+        {
+            POS_T type = mtx[square_x(sq)][square_y(sq)];
+            if (type == 1 || type == 2)
+                key ^= zobrist.piece[type][sq];
+            else if (type)
+                key += zobrist.side[0]; // дамки учитываются только количеством
+        }
+        return key;
+    }
+
+    std::vector<uint64_t> hashes; // хеш расстановки в начале хода
+    std::vector<uint64_t> men;    // men_key в начале хода
+    std::vector<int> clock;       // полуходов с последнего необратимого хода
+};
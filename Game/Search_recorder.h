@@ -0,0 +1,184 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../Models/Search.h"
+#include "../Models/Search_tree.h"
+
+// Запись дерева поиска для разбора отсечений (Log/SearchTree, Tools/treestat). Logic сообщает о входе в узел
+// и выходе из него, о числе ходов, отсечении и отсечении по таблице; узлы итерации копятся в буфере и
+// дописываются в файл целиком в конце итерации. Объём ограничен глубиной записанного дерева (max_level)
+// и выборкой: на уровне sample_level записывается каждое sample-е поддерево (по хешу позиции, поэтому
+// выбор не зависит от порядка ходов). Незаписанные узлы учитываются в счётчике узлов предков.
+// Один объект — для одного потока поиска; файл с тем же путём общий для всех объектов программы.
+class Search_recorder
+{
+public:
+    static const size_t MAX_ITERATION_NODES = size_t(1) << 22; // узлов итерации в буфере (64 МБ)
+
+    // Файл открывается заново первым объектом с этим путём, остальные дописывают в него
+    Search_recorder(const std::string& path, const int max_level, const int sample_level, const int sample)
+        : max_level(size_t(max_level)), sample_level(size_t(sample_level)), sample(uint64_t(sample))
+    {
+        Search_tree_header header;
+        header.max_level = uint8_t(max_level);
+        header.sample_level = uint8_t(sample_level);
+        header.sample = uint32_t(sample);
+        file = open_file(path, header);
+    }
+
+    bool is_open() const
+    {
+        return file != nullptr;
+    }
+
+    // Корень итерации на plies полуходов; nodes — счётчик узлов поиска до неё
+    void begin_iteration(const int plies, const size_t root_moves, const uint64_t nodes)
+    {
+        buffer.clear();
+        stack.clear();
+        truncated = false;
+        pending = Packed_move();
+        Open_node root;
+        root.node.alpha = -SCORE_INF;
+        root.node.beta = SCORE_INF;
+        root.node.move.bits = uint16_t(plies);
+        root.node.moves = uint8_t(std::min<size_t>(root_moves, 255));
+        root.nodes_before = nodes;
+        stack.push_back(root);
+    }
+
+    // Конец итерации: корень и все узлы итерации дописываются в файл
+    void end_iteration(const int score, const uint64_t nodes, const bool aborted)
+    {
+        Open_node& root = stack.front();
+        root.node.score = int16_t(score);
+        root.node.nodes = clamp_nodes(nodes - root.nodes_before);
+        root.node.flags |= (aborted ? Search_tree_node::ABORTED : 0) | (truncated ? Search_tree_node::TRUNCATED : 0);
+        buffer.push_back(root.node);
+        stack.clear();
+        std::lock_guard<std::mutex> lock(file->mtx);
+        fwrite(buffer.data(), sizeof(Search_tree_node), buffer.size(), file->out);
+        fflush(file->out);
+    }
+
+    // Ход вглубь по пути поиска: станет ходом следующего узла
+    void push_move(const Packed_move move)
+    {
+        pending = move;
+    }
+
+    // Вход в узел: окно, продолжается ли в нём серия взятий, хеш позиции (для выборки), счётчик узлов поиска
+    void enter(const int alpha, const int beta, const bool chain, const uint64_t key, const uint64_t nodes)
+    {
+        const size_t level = stack.size();
+        bool recorded = stack.back().recorded && level <= max_level;
+        if (recorded && level == sample_level && sample > 1)
+            recorded = ((key * 0x9E3779B97F4A7C15ull) >> 32) % sample == 0;
+        if (recorded && buffer.size() + level >= MAX_ITERATION_NODES)
+        {
+            recorded = false;
+            truncated = true;
+        }
+        Open_node open;
+        open.recorded = recorded;
+        open.nodes_before = nodes;
+        if (recorded)
+        {
+            open.node.alpha = int16_t(alpha);
+            open.node.beta = int16_t(beta);
+            open.node.move = pending;
+            open.node.level = uint8_t(level);
+            open.node.flags = (chain ? Search_tree_node::CHAIN : 0);
+        }
+        pending = Packed_move();
+        stack.push_back(open);
+    }
+
+    void leave(const int score, const uint64_t nodes)
+    {
+        Open_node& open = stack.back();
+        if (open.recorded)
+        {
+            open.node.score = int16_t(score);
+            open.node.nodes = clamp_nodes(nodes - open.nodes_before);
+            buffer.push_back(open.node);
+        }
+        stack.pop_back();
+    }
+
+    // Узел раскрыт: moves ходов
+    void expanded(const size_t moves)
+    {
+        stack.back().node.moves = uint8_t(std::min<size_t>(moves, 255));
+    }
+
+    // Отсечение на ходе index
+    void cutoff(const size_t index)
+    {
+        stack.back().node.cutoff = uint8_t(std::min<size_t>(index, Search_tree_node::NO_CUTOFF - 1));
+    }
+
+    void tt_cutoff()
+    {
+        stack.back().node.flags |= Search_tree_node::TT_CUTOFF;
+    }
+
+private:
+    struct Open_node
+    {
+        Search_tree_node node;
+        uint64_t nodes_before = 0; // счётчик узлов поиска при входе
+        bool recorded = true;
+    };
+
+    // Файл, общий для объектов с одним путём
+    struct Shared_file
+    {
+        std::mutex mtx;
+        FILE* out = nullptr;
+
+        ~Shared_file()
+        {
+            if (out)
+                fclose(out);
+        }
+    };
+
+    static std::shared_ptr<Shared_file> open_file(const std::string& path, const Search_tree_header& header)
+    {
+        static std::mutex registry_mtx;
+        static std::map<std::string, std::weak_ptr<Shared_file>> registry;
+        std::lock_guard<std::mutex> lock(registry_mtx);
+        auto file = registry[path].lock();
+        if (file)
+            return file;
+        file = std::make_shared<Shared_file>();
+        file->out = fopen(path.c_str(), "wb");
+        if (!file->out || fwrite(&header, sizeof(header), 1, file->out) != 1)
+            return nullptr;
+        registry[path] = file;
+        return file;
+    }
+
+    static uint32_t clamp_nodes(const uint64_t nodes)
+    {
+        return uint32_t(std::min<uint64_t>(nodes, std::numeric_limits<uint32_t>::max()));
+    }
+
+    size_t max_level;
+    size_t sample_level;
+    uint64_t sample;
+    std::shared_ptr<Shared_file> file;
+    std::vector<Open_node> stack;           // узлы текущего пути поиска (и незаписанные)
+    std::vector<Search_tree_node> buffer;   // законченные узлы итерации
+    Packed_move pending;                    // ход в следующий узел
+    bool truncated = false;
+};
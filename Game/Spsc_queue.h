@@ -0,0 +1,37 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+// Очередь без блокировок для одного писателя и одного читателя (кольцевой буфер фиксированного размера).
+// push и pop никогда не ждут: при полной очереди push возвращает false, при пустой — pop.
+// Счётчики писателя и читателя лежат в разных строках кэша, чтобы потоки не мешали друг другу.
+template <class T, size_t CAPACITY> class Spsc_queue
+{
+public:
+    // Только из потока писателя
+    bool push(const T& value)
+    {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) == CAPACITY)
+            return false;
+        buf[head % CAPACITY] = value;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Только из потока читателя
+    bool pop(T& value)
+    {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire))
+            return false;
+        value = buf[tail % CAPACITY];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    alignas(64) std::atomic<size_t> head_{ 0 }; // сколько записано
+    alignas(64) std::atomic<size_t> tail_{ 0 }; // сколько прочитано
+    alignas(64) T buf[CAPACITY];
+};
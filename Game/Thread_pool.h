@@ -0,0 +1,146 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Пул потоков фиксированного размера с перехватом задач (work stealing).
+// У каждого потока своя очередь для задач, добавленных из этого потока; внешние задачи попадают
+// в общую очередь и выполняются в порядке поступления (иначе новый запрос обгоняет старые и те
+// не укладываются в свои сроки). Свободный поток сначала берёт задачу из своей очереди (с конца),
+// затем самую старую внешнюю, а если и её нет — забирает самую старую задачу у соседей.
+// Задача получает номер потока, чтобы пользоваться его личными ресурсами (например, своим Logic).
+class Thread_pool
+{
+public:
+    using Task = std::function<void(int)>;
+
+    explicit Thread_pool(const int threads)
+    {
+        for (int i = 0; i < threads; ++i)
+            queues.emplace_back(new Queue());
+        for (int i = 0; i < threads; ++i)
+            workers.emplace_back(&Thread_pool::run, this, i);
+    }
+
+    // Деструктор дожидается выполнения всех задач
+    ~Thread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(wait_mtx);
+            done = true;
+        }
+        cv.notify_all();
+        for (auto& worker : workers)
+            worker.join();
+    }
+
+    void submit(Task task)
+    {
+        const int id = current_worker();
+        Queue& queue = (id >= 0 && id < int(queues.size()) ? *queues[id] : external);
+        {
+            std::lock_guard<std::mutex> lock(queue.mtx);
+            queue.tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(wait_mtx);
+            ++pending;
+        }
+        cv.notify_one();
+    }
+
+    int size() const
+    {
+        return int(workers.size());
+    }
+
+    // Число задач, ожидающих выполнения
+    size_t queued() const
+    {
+        return pending.load();
+    }
+
+private:
+    struct Queue
+    {
+        std::mutex mtx;
+        std::deque<Task> tasks;
+    };
+
+    // Номер потока пула, в котором выполняется код (-1 — не поток пула)
+    static int& current_worker()
+    {
+        static thread_local int id = -1;
+        return id;
+    }
+
+    bool pop(const int id, Task& task)
+    {
+        std::lock_guard<std::mutex> lock(queues[id]->mtx);
+        if (queues[id]->tasks.empty())
+            return false;
+        task = std::move(queues[id]->tasks.back());
+        queues[id]->tasks.pop_back();
+        return true;
+    }
+
+    bool pop_external(Task& task)
+    {
+        std::lock_guard<std::mutex> lock(external.mtx);
+        if (external.tasks.empty())
+            return false;
+        task = std::move(external.tasks.front());
+        external.tasks.pop_front();
+        return true;
+    }
+
+    bool steal(const int id, Task& task)
+    {
+        for (size_t k = 1; k < queues.size(); ++k)
+        {
+            Queue& victim = *queues[(id + k) % queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mtx);
+            if (victim.tasks.empty())
+                continue;
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+        return false;
+    }
+
+    void run(const int id)
+    {
+        current_worker() = id;
+        while (true)
+        {
+            Task task;
+            if (pop(id, task) || pop_external(task) || steal(id, task))
+            {
+                {
+                    std::lock_guard<std::mutex> lock(wait_mtx);
+                    --pending;
+                }
+                task(id);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(wait_mtx);
+            cv.wait(lock, [this]() { return done || pending > 0; });
+            if (done && pending == 0)
+                return;
+        }
+    }
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    Queue external; // задачи не из потоков пула
+    std::vector<std::thread> workers;
+    std::mutex wait_mtx;
+    std::condition_variable cv;
+    std::atomic<size_t> pending{ 0 };
+    bool done = false;
+};
@@ -0,0 +1,89 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+
+#include "../Models/Search.h"
+
+// Распределение времени ботов на всю партию: у каждого цвета общий запас времени и прибавка за ход.
+// На каждый ход выдаются два лимита:
+//  - мягкий: после него новая итерация углубления не начинается;
+//  - жёсткий: на нём поиск прерывается (передаётся в Search_limits::time_ms).
+// Оба считаются из оставшегося времени и числа оставшихся ходов. Если лучший ход меняется между
+// итерациями, мягкий лимит увеличивается. Единственный допустимый ход Logic::search возвращает сразу.
+class Time_manager
+{
+public:
+    // Начало партии: game_ms — запас времени каждого бота (0 — распределение выключено), increment_ms — прибавка за ход
+    void new_game(const long long game_ms, const long long increment_ms)
+    {
+        increment = increment_ms;
+        remaining[0] = remaining[1] = game_ms;
+        enabled = (game_ms > 0);
+    }
+
+    bool is_enabled() const
+    {
+        return enabled;
+    }
+
+    // Оставшееся время цвета
+    long long get_remaining(const bool color) const
+    {
+        return remaining[color];
+    }
+
+    // Лимиты хода цвета color, turns_left — сколько полуходов осталось до конца партии (Game/MaxNumTurns)
+    Search_limits start_move(const bool color, const int turns_left)
+    {
+        const long long moves_to_go = std::max(1, std::min((turns_left + 1) / 2, MAX_MOVES_TO_GO));
+        const long long left = std::max(0LL, remaining[color] - SAFETY_MS);
+        const long long base = left / moves_to_go + increment;
+        soft_ms = base / 2;
+        hard_ms = std::min(base * 3, left / 2 + increment);
+        changes = 0;
+        have_best = false;
+        stop = false;
+
+        Search_limits limits;
+        limits.depth = 64;
+        limits.time_ms = std::max(1LL, std::min(hard_ms, left)); // при нулевом запасе — только первая итерация
+        limits.stop = &stop;
+        return limits;
+    }
+
+    // Вызывается после каждой завершённой итерации (Logic::search, on_iteration):
+    // решает, начинать ли следующую
+    void on_iteration(const Search_info& info)
+    {
+        if (!info.pv.empty())
+        {
+            if (have_best && info.pv[0] != best)
+                changes = std::min(changes + 1, MAX_CHANGES);
+            best = info.pv[0];
+            have_best = true;
+        }
+        // каждая смена лучшего хода добавляет половину мягкого лимита
+        if (info.time_ms >= soft_ms * (2 + changes) / 2)
+            stop = true;
+    }
+
+    // Конец хода: списывается потраченное время, начисляется прибавка
+    void end_move(const bool color, const long long spent_ms)
+    {
+        remaining[color] = std::max(0LL, remaining[color] - spent_ms) + increment;
+    }
+
+private:
+    static const int MAX_MOVES_TO_GO = 30;   // горизонт планирования в ходах
+    static const int MAX_CHANGES = 3;        // больше смен лучшего хода мягкий лимит не увеличивают
+    static const long long SAFETY_MS = 50;   // запас на отрисовку и задержки
+
+    bool enabled = false;
+    long long increment = 0;
+    long long remaining[2] = { 0, 0 };
+    long long soft_ms = 0, hard_ms = 0;
+    int changes = 0;         // смены лучшего хода между итерациями текущего хода
+    bool have_best = false;
+    move_pos best{ -1, -1, -1, -1 };
+    std::atomic<bool> stop{ false }; // выставляется по мягкому лимиту, поиск прерывает следующую итерацию
+};
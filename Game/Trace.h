@@ -0,0 +1,164 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Трассировка этапов игры и поиска во времени (формат Chrome trace / Perfetto).
+// TRACE_SCOPE("имя") отмечает интервал от объявления до конца блока. Интервалы пишутся в кольцевой буфер
+// своего потока без блокировок; Trace::dump() сохраняет все буферы в JSON, который открывается
+// в chrome://tracing или ui.perfetto.dev. Пока трассировка выключена, TRACE_SCOPE стоит одну проверку флага.
+// dump() можно вызывать на ходу (F12): у каждой ячейки буфера есть номер записи, и ячейка, которую поток
+// переписал во время чтения, пропускается.
+class Trace
+{
+public:
+    static void set_enabled(const bool enabled)
+    {
+        state().enabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    static bool is_enabled()
+    {
+        return state().enabled.load(std::memory_order_relaxed);
+    }
+
+    // Файл, в который пишет dump() без аргументов
+    static void set_path(const std::string& path)
+    {
+        std::lock_guard<std::mutex> lock(state().mtx);
+        state().path = path;
+    }
+
+    // Время от старта программы в микросекундах
+    static int64_t now_us()
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - state().start)
+            .count();
+    }
+
+    // Запись завершённого интервала в буфер текущего потока
+    static void record(const char* name, const int64_t begin_us, const int64_t end_us)
+    {
+        Buffer& buf = thread_buffer();
+        const uint64_t pos = buf.head.load(std::memory_order_relaxed);
+        Event& ev = buf.events[pos % CAPACITY];
+        ev.seq.store(2 * pos + 1, std::memory_order_relaxed); // нечётный номер — ячейка пишется
+        std::atomic_thread_fence(std::memory_order_release);
+        ev.name.store(name, std::memory_order_relaxed);
+        ev.begin_us.store(begin_us, std::memory_order_relaxed);
+        ev.dur_us.store(end_us - begin_us, std::memory_order_relaxed);
+        ev.seq.store(2 * pos + 2, std::memory_order_release);
+        buf.head.store(pos + 1, std::memory_order_release);
+    }
+
+    // Сохранение всех буферов; при переполнении в буфере остаются последние CAPACITY интервалов потока.
+    // Интервалы, переписанные потоком во время сохранения, пропускаются
+    static bool dump(const std::string& path = "")
+    {
+        std::lock_guard<std::mutex> lock(state().mtx);
+        std::ofstream fout(path.empty() ? state().path : path);
+        if (!fout)
+            return false;
+        fout << "{\"traceEvents\":[";
+        bool first = true;
+        for (const auto& buf : state().buffers)
+        {
+            const uint64_t head = buf->head.load(std::memory_order_acquire);
+            const uint64_t begin = (head > CAPACITY ? head - CAPACITY : 0);
+            for (uint64_t i = begin; i < head; ++i)
+            {
+                const Event& ev = buf->events[i % CAPACITY];
+                const uint64_t seq = ev.seq.load(std::memory_order_acquire);
+                const char* name = ev.name.load(std::memory_order_relaxed);
+                const int64_t begin_us = ev.begin_us.load(std::memory_order_relaxed);
+                const int64_t dur_us = ev.dur_us.load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (seq != 2 * i + 2 || ev.seq.load(std::memory_order_relaxed) != seq)
+                    continue; // ячейка ещё пишется или уже занята более новым интервалом
+                fout << (first ? "" : ",") << "\n{\"name\":\"" << name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+                     << buf->tid << ",\"ts\":" << begin_us << ",\"dur\":" << dur_us << "}";
+                first = false;
+            }
+        }
+        fout << "\n]}\n";
+        return bool(fout);
+    }
+
+private:
+    static const uint64_t CAPACITY = 1 << 16; // интервалов на поток
+
+    // Ячейка буфера: поля атомарные, потому что dump() читает их, пока поток пишет
+    struct Event
+    {
+        std::atomic<uint64_t> seq{ 0 };          // 2 * номер записи + 2 — записана, нечётный — пишется
+        std::atomic<const char*> name{ nullptr }; // строковый литерал
+        std::atomic<int64_t> begin_us{ 0 };
+        std::atomic<int64_t> dur_us{ 0 };
+    };
+
+    struct Buffer
+    {
+        std::vector<Event> events = std::vector<Event>(CAPACITY);
+        std::atomic<uint64_t> head{ 0 };
+        int tid = 0;
+    };
+
+    struct State
+    {
+        std::atomic<bool> enabled{ false };
+        std::mutex mtx;
+        std::string path = "trace.json";
+        std::vector<std::shared_ptr<Buffer>> buffers; // буферы живут до конца программы
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    };
+
+    static State& state()
+    {
+        static State st;
+        return st;
+    }
+
+    // Буфер потока создаётся при первой записи и регистрируется для dump()
+    static Buffer& thread_buffer()
+    {
+        static thread_local std::shared_ptr<Buffer> buf;
+        if (!buf)
+        {
+            buf = std::make_shared<Buffer>();
+            std::lock_guard<std::mutex> lock(state().mtx);
+            buf->tid = int(state().buffers.size()) + 1;
+            state().buffers.push_back(buf);
+        }
+        return *buf;
+    }
+};
+
+// Интервал от создания до уничтожения объекта
+class Trace_span
+{
+public:
+    explicit Trace_span(const char* name) : name(name), begin_us(Trace::is_enabled() ? Trace::now_us() : -1)
+    {
+    }
+
+    ~Trace_span()
+    {
+        if (begin_us >= 0)
+            Trace::record(name, begin_us, Trace::now_us());
+    }
+
+private:
+    const char* name;
+    int64_t begin_us;
+};
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(name) Trace_span TRACE_CONCAT(trace_span_, __LINE__)(name)
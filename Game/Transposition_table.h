@@ -0,0 +1,119 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "../Models/Move.h"
+
+// Таблица транспозиций: результаты поиска по хешу позиции.
+// Запись — два 64-битных слова (ключ XOR данные и данные), без блокировок: одна таблица может
+// использоваться сразу несколькими поисками в разных потоках. Если запись прочитана наполовину
+// обновлённой, ключ не сойдётся и запись просто не будет найдена.
+class Transposition_table
+{
+public:
+    // Тип оценки в записи
+    enum Bound : uint8_t
+    {
+        BOUND_NONE = 0,
+        BOUND_UPPER = 1, // настоящая оценка не больше записанной
+        BOUND_LOWER = 2, // настоящая оценка не меньше записанной
+        BOUND_EXACT = 3
+    };
+
+    struct Entry
+    {
+        int score = 0;       // оценка для стороны, которая ходит (выигрыш — от этой позиции, см. Logic)
+        int depth = 0;       // оставшаяся глубина, на которой получена оценка
+        Bound bound = BOUND_NONE;
+        Packed_move move;    // лучший ход (пустой — нет)
+    };
+
+    explicit Transposition_table(const size_t size_mb = 16)
+    {
+        size_t count = 1;
+        while (count * 2 * sizeof(Slot) <= size_mb * (1 << 20))
+            count *= 2;
+        slots = std::vector<Slot>(count);
+        mask = count - 1;
+    }
+
+    // Новый поиск: старые записи становятся кандидатами на замену
+    void new_search()
+    {
+        generation.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void clear()
+    {
+        for (auto& slot : slots)
+        {
+            slot.key.store(0, std::memory_order_relaxed);
+            slot.data.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    bool probe(const uint64_t key, Entry& entry) const
+    {
+        const Slot& slot = slots[key & mask];
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        if ((slot.key.load(std::memory_order_relaxed) ^ data) != key || data == 0)
+            return false;
+        entry = unpack(data);
+        return true;
+    }
+
+    void store(const uint64_t key, const int score, const int depth, const Bound bound, const Packed_move move)
+    {
+        Slot& slot = slots[key & mask];
+        const uint64_t old = slot.data.load(std::memory_order_relaxed);
+        const bool same = ((slot.key.load(std::memory_order_relaxed) ^ old) == key);
+        const uint8_t gen = generation.load(std::memory_order_relaxed);
+        // замещаем пустые, устаревшие и менее глубокие записи, а также запись той же позиции
+        if (old && !same && (old >> 58) == (gen & 63u) && int((old >> 32) & 255) > depth)
+            return;
+        const uint64_t data = pack(score, depth, bound, move, gen);
+        slot.key.store(key ^ data, std::memory_order_relaxed);
+        slot.data.store(data, std::memory_order_relaxed);
+    }
+
+    size_t size_bytes() const
+    {
+        return slots.size() * sizeof(Slot);
+    }
+
+    // Данные: биты 0-31 — оценка (int32), 32-39 — глубина, 40-41 — тип оценки,
+    // 42-57 — лучший ход (Packed_move), 58-63 — поколение (младшие 6 бит)
+    static uint64_t pack(const int score, const int depth, const Bound bound, const Packed_move move,
+        const uint8_t gen)
+    {
+        return uint64_t(uint32_t(score)) | (uint64_t(depth & 255) << 32) | (uint64_t(bound) << 40) |
+               (uint64_t(move.bits) << 42) | (uint64_t(gen & 63u) << 58);
+    }
+
+    static Entry unpack(const uint64_t data)
+    {
+        Entry entry;
+        entry.score = int32_t(uint32_t(data));
+        entry.depth = int((data >> 32) & 255);
+        entry.bound = Bound((data >> 40) & 3);
+        entry.move.bits = uint16_t(data >> 42);
+        return entry;
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<uint64_t> key{ 0 };
+        std::atomic<uint64_t> data{ 0 };
+
+        Slot() = default;
+        Slot(const Slot&) : key(0), data(0)
+        {
+        }
+    };
+
+    std::vector<Slot> slots;
+    size_t mask = 0;
+    std::atomic<uint8_t> generation{ 1 };
+};
@@ -0,0 +1,69 @@
+#pragma once
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "../Models/Move.h"
+#include "../Models/Position_record.h"
+#include "../Models/Rules.h"
+
+// Ключи Zobrist для хеширования позиций.
+// Генератор с фиксированным зерном: ключи одинаковы во всех процессах и запусках,
+// поэтому хеши можно хранить в файлах и передавать между программами.
+class Zobrist
+{
+public:
+    static const Zobrist& get()
+    {
+        static const Zobrist keys;
+        return keys;
+    }
+
+    static const int MAX_SQUARES = 50; // игровых клеток на самой большой доске (10x10)
+
+    // Хеш расстановки фигур (без очереди хода) на доске варианта Rules
+    template <class Rules = Russian_rules>
+    uint64_t board_hash(const std::vector<std::vector<POS_T>>& mtx) const
+    {
+        uint64_t hash = 0;
+        for (int sq = 0; sq < rules_squares<Rules>(); ++sq)
+        {
+            POS_T type = mtx[rules_square_x<Rules>(sq)][rules_square_y<Rules>(sq)];
+            if (type)
+                hash ^= piece[type][sq];
+        }
+        return hash;
+    }
+
+    // Изменение хеша расстановки после хода turn на доске mtx (до хода); new_type — фигура на клетке
+    // назначения (превращение в дамку зависит от правил варианта и считается в Logic_t::moved_type)
+    template <class Rules = Russian_rules>
+    uint64_t turn_delta(const std::vector<std::vector<POS_T>>& mtx, const move_pos& turn, const POS_T new_type) const
+    {
+        uint64_t delta = piece[mtx[turn.x][turn.y]][rules_square<Rules>(turn.x, turn.y)];
+        if (turn.xb != -1)
+            delta ^= piece[mtx[turn.xb][turn.yb]][rules_square<Rules>(turn.xb, turn.yb)];
+        return delta ^ piece[new_type][rules_square<Rules>(turn.x2, turn.y2)];
+    }
+
+    uint64_t piece[5][MAX_SQUARES]; // [тип фигуры 1..4][клетка]
+    uint64_t side[2];               // очередь хода
+    uint64_t bot[2];                // цвет, с точки зрения которого записан результат (Pn_solver)
+
+private:
+    Zobrist()
+    {
+        std::mt19937_64 rng(0x436865636B657273ull); // "Checkers"
+        for (auto& row : piece)
+            for (int sq = 0; sq < 32; ++sq)
+                row[sq] = rng();
+        for (auto& key : side)
+            key = rng();
+        for (auto& key : bot)
+            key = rng();
+        // клетки больших досок — после остальных ключей, чтобы хеши доски 8x8 не изменились
+        for (auto& row : piece)
+            for (int sq = 32; sq < MAX_SQUARES; ++sq)
+                row[sq] = rng();
+    }
+};
@@ -0,0 +1,107 @@
+#pragma once
+#include <fstream>
+#include <string>
+#include <nlohmann/json.hpp>
+
+#include "Move.h"
+
+// Параметры оценочной функции Logic::calc_score.
+// Сила стороны — сумма вкладов её фигур; шашка стоит 1 (это масштаб, отношение сил от него не зависит),
+// остальные параметры подбираются утилитой Tools/tune.cpp и загружаются из файла (EvalParamsPath).
+struct Eval_params
+{
+    static const int N = 4; // число настраиваемых параметров
+
+    double king = 5;         // ценность дамки
+    double advance = 0.05;   // бонус шашке за каждый ряд продвижения к дамочному полю
+    double back_rank = 0;    // бонус шашке, оставшейся на своём первом ряду (защита от дамок)
+    double center = 0;       // бонус шашке в центре доски (два средних ряда, кроме двух крайних столбцов)
+
+    // Параметры "по умолчанию" для встроенных режимов оценки
+    static Eval_params defaults(const std::string& scoring_mode)
+    {
+        Eval_params params;
+        if (scoring_mode == "NumberOnly")
+        {
+            params.king = 4;
+            params.advance = 0;
+        }
+        return params;
+    }
+
+    // Доступ к параметрам по номеру (для утилиты подбора)
+    double& operator[](const int k)
+    {
+        switch (k)
+        {
+        case 0:
+            return king;
+        case 1:
+            return advance;
+        case 2:
+            return back_rank;
+        default:
+            return center;
+        }
+    }
+
+    double operator[](const int k) const
+    {
+        return const_cast<Eval_params&>(*this)[k];
+    }
+
+    // Признаки фигуры type на клетке (i, j) доски size x size: f[0] — константа (1 для шашки),
+    // f[1..N] — коэффициенты при параметрах. Вклад фигуры равен f[0] + сумма f[k + 1] * params[k].
+    static void piece_features(const POS_T type, const POS_T i, const POS_T j, double f[N + 1], const int size = 8)
+    {
+        for (int k = 0; k <= N; ++k)
+            f[k] = 0;
+        if (type > 2)
+        {
+            f[1] = 1;
+            return;
+        }
+        f[0] = 1;
+        f[2] = (type == 1 ? size - 1 - i : i);
+        f[3] = (type == 1 ? i == size - 1 : i == 0);
+        f[4] = (i >= size / 2 - 1 && i <= size / 2 && j >= 2 && j <= size - 3);
+    }
+
+    // Вклад фигуры в силу своей стороны
+    double piece_value(const POS_T type, const POS_T i, const POS_T j, const int size = 8) const
+    {
+        double f[N + 1];
+        piece_features(type, i, j, f, size);
+        double value = f[0];
+        for (int k = 0; k < N; ++k)
+            value += f[k + 1] * (*this)[k];
+        return value;
+    }
+
+    bool load(const std::string& path)
+    {
+        std::ifstream fin(path);
+        if (!fin)
+            return false;
+        nlohmann::json js = nlohmann::json::parse(fin, nullptr, false, true);
+        if (js.is_discarded())
+            return false;
+        king = js.value("King", king);
+        advance = js.value("Advance", advance);
+        back_rank = js.value("BackRank", back_rank);
+        center = js.value("Center", center);
+        return true;
+    }
+
+    bool save(const std::string& path) const
+    {
+        nlohmann::json js;
+        js["King"] = king;
+        js["Advance"] = advance;
+        js["BackRank"] = back_rank;
+        js["Center"] = center;
+        std::ofstream fout(path);
+        fout << js.dump(4) << "\n";
+        return bool(fout);
+    }
+};
@@ -0,0 +1,139 @@
+#pragma once
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Move.h"
+#include "Position_record.h"
+
+// Текстовая запись позиций и ходов (в духе PDN FEN).
+// Клетки нумеруются 1..32: номер = square_index(x, y) + 1, т.е. чёрные начинают на 1..12, белые на 21..32.
+// Позиция: "<W|B>:W<клетки белых>:B<клетки чёрных>", дамки помечаются K, например "W:W21,22,K30:B1,2,3".
+// Ход: "<откуда>-<куда>", серия взятий: "<откуда>x<куда>x<куда>...".
+
+inline std::string start_fen()
+{
+    return "W:W21,22,23,24,25,26,27,28,29,30,31,32:B1,2,3,4,5,6,7,8,9,10,11,12";
+}
+
+inline std::string to_fen(const std::vector<std::vector<POS_T>>& mtx, const bool color)
+{
+    std::string side[2];
+    for (int sq = 0; sq < 32; ++sq)
+    {
+        POS_T type = mtx[square_x(sq)][square_y(sq)];
+        if (!type)
+            continue;
+        std::string& out = side[type % 2 == 0];
+        if (!out.empty())
+            out += ",";
+        if (type > 2)
+            out += "K";
+        out += std::to_string(sq + 1);
+    }
+    return std::string(color ? "B" : "W") + ":W" + side[0] + ":B" + side[1];
+}
+
+// Разбор позиции; при ошибке возвращает false и не меняет mtx/color
+inline bool from_fen(const std::string& fen, std::vector<std::vector<POS_T>>& mtx, bool& color)
+{
+    std::vector<std::vector<POS_T>> res(8, std::vector<POS_T>(8, 0));
+    std::stringstream ss(fen);
+    std::string part;
+    if (!std::getline(ss, part, ':') || (part != "W" && part != "B"))
+        return false;
+    const bool res_color = (part == "B");
+    while (std::getline(ss, part, ':'))
+    {
+        if (part.empty() || (part[0] != 'W' && part[0] != 'B'))
+            return false;
+        const POS_T man = (part[0] == 'W' ? 1 : 2);
+        std::stringstream list(part.substr(1));
+        std::string item;
+        while (std::getline(list, item, ','))
+        {
+            if (item.empty())
+                continue;
+            POS_T type = man;
+            if (item[0] == 'K')
+            {
+                type += 2;
+                item = item.substr(1);
+            }
+            int num = 0;
+            try
+            {
+                num = std::stoi(item);
+            }
+            catch (...)
+            {
+                return false;
+            }
+            if (num < 1 || num > 32)
+                return false;
+            res[square_x(num - 1)][square_y(num - 1)] = type;
+        }
+    }
+    mtx = res;
+    color = res_color;
+    return true;
+}
+
+// Запись хода (или серии взятий) одной строкой
+inline std::string move_to_string(const std::vector<move_pos>& turns)
+{
+    std::string res;
+    for (size_t i = 0; i < turns.size(); ++i)
+    {
+        if (i == 0)
+            res = std::to_string(square_index(turns[i].x, turns[i].y) + 1);
+        res += (turns[i].xb != -1 ? "x" : "-");
+        res += std::to_string(square_index(turns[i].x2, turns[i].y2) + 1);
+    }
+    return res;
+}
+
+// Номера клеток хода "a-b" / "axbxc" (0..31); пустой список — ошибка разбора
+inline std::vector<int> parse_move(const std::string& text)
+{
+    std::vector<int> squares;
+    std::string num;
+    for (size_t i = 0; i <= text.size(); ++i)
+    {
+        if (i < text.size() && isdigit((unsigned char)text[i]))
+        {
+            num += text[i];
+            continue;
+        }
+        if (num.empty() || num.size() > 2 || (i < text.size() && text[i] != '-' && text[i] != 'x'))
+            return {}; // номер клетки — не больше двух цифр (длинный не поместился бы в stoi)
+        int sq = std::stoi(num) - 1;
+        if (sq < 0 || sq > 31)
+            return {};
+        squares.push_back(sq);
+        num.clear();
+    }
+    if (squares.size() < 2)
+        return {};
+    return squares;
+}
+
+// Запись главного варианта: шаги одной серии взятий объединяются в один ход
+inline std::string pv_to_string(const std::vector<move_pos>& pv)
+{
+    std::string res;
+    std::vector<move_pos> chain;
+    for (const auto& turn : pv)
+    {
+        if (!chain.empty() && !(chain.back().xb != -1 && turn.xb != -1 && turn.x == chain.back().x2 &&
+                                  turn.y == chain.back().y2))
+        {
+            res += (res.empty() ? "" : " ") + move_to_string(chain);
+            chain.clear();
+        }
+        chain.push_back(turn);
+    }
+    if (!chain.empty())
+        res += (res.empty() ? "" : " ") + move_to_string(chain);
+    return res;
+}
@@ -0,0 +1,165 @@
+#pragma once
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "Move.h"
+#include "Position_record.h"
+
+// Запись партии для архива (Game/Game_archive.h): начальная позиция, ходы и итог.
+// Ход — серия шагов (обычный ход — один шаг). В архиве шаг занимает байт: биты 0-4 — откуда, 5-6 — направление
+// (бит 5 — вниз по x, бит 6 — вправо по y), 7 — серия взятий продолжается следующим шагом. Дальность шага
+// шашки понятна по доске (1 — ход, 2 — взятие), у дамки она записана следующим байтом. Побитые фигуры
+// не хранятся: и запись, и чтение проигрывают партию от начальной позиции.
+struct Game_record
+{
+    uint32_t white = 0xFFF00000u; // начальная позиция (маски по 32 игровым клеткам, как в Position_record)
+    uint32_t black = 0x00000FFFu;
+    uint32_t kings = 0;
+    bool side = false; // кто ходит первым (1 = чёрные)
+    std::vector<std::vector<move_pos>> turns;
+    Record_result result = RESULT_DRAW;
+
+    bool is_standard_start() const
+    {
+        return white == 0xFFF00000u && black == 0x00000FFFu && !kings && !side;
+    }
+
+    void set_start(const std::vector<std::vector<POS_T>>& mtx, const bool color)
+    {
+        Position_record rec;
+        rec.set_board(mtx);
+        white = rec.white;
+        black = rec.black;
+        kings = rec.kings;
+        side = color;
+    }
+
+    std::vector<std::vector<POS_T>> start_board() const
+    {
+        Position_record rec;
+        rec.white = white;
+        rec.black = black;
+        rec.kings = kings;
+        return rec.get_board();
+    }
+
+    // Запись в конец out: байт флагов (бит 0 — нестандартная начальная позиция: ещё 13 байт), затем шаги.
+    // Шаги должны быть ходами по диагонали на свободную клетку
+    void encode(std::vector<uint8_t>& out) const
+    {
+        const bool custom = !is_standard_start();
+        out.push_back(uint8_t(custom));
+        if (custom)
+        {
+            for (const uint32_t mask : { white, black, kings })
+                for (int i = 0; i < 4; ++i)
+                    out.push_back(uint8_t(mask >> (8 * i)));
+            out.push_back(uint8_t(side));
+        }
+        POS_T board[32];
+        fill_board(board);
+        for (const auto& turn : turns)
+            for (size_t i = 0; i < turn.size(); ++i)
+            {
+                const auto& mv = turn[i];
+                const int from = square_index(mv.x, mv.y);
+                out.push_back(uint8_t(from | (mv.x2 > mv.x) << 5 | (mv.y2 > mv.y) << 6 | (i + 1 < turn.size()) << 7));
+                if (board[from] > 2)
+                    out.push_back(uint8_t(abs(mv.x2 - mv.x)));
+                play(board, mv);
+            }
+    }
+
+    // Разбор plies ходов из data (не больше size байт). Память под ходы переиспользуется,
+    // поэтому при проходе по архиву одну запись лучше читать повторно.
+    // Возвращает число прочитанных байт, 0 — запись повреждена
+    size_t decode(const uint8_t* data, const size_t size, const int plies)
+    {
+        size_t pos = 0;
+        if (size < 1)
+            return 0;
+        const bool custom = data[pos++] & 1;
+        white = 0xFFF00000u;
+        black = 0x00000FFFu;
+        kings = 0;
+        side = false;
+        if (custom)
+        {
+            if (size < 14)
+                return 0;
+            uint32_t* masks[3] = { &white, &black, &kings };
+            for (auto mask : masks)
+            {
+                *mask = uint32_t(data[pos]) | uint32_t(data[pos + 1]) << 8 | uint32_t(data[pos + 2]) << 16 |
+                        uint32_t(data[pos + 3]) << 24;
+                pos += 4;
+            }
+            side = data[pos++] & 1;
+        }
+
+        POS_T board[32];
+        fill_board(board);
+        turns.resize(plies);
+        for (auto& turn : turns)
+        {
+            turn.clear();
+            bool more = true;
+            while (more)
+            {
+                if (pos >= size)
+                    return 0;
+                const unsigned step = data[pos++];
+                more = step >> 7;
+                const int from = step & 31, dx = (step >> 5 & 1) ? 1 : -1, dy = (step >> 6 & 1) ? 1 : -1;
+                const POS_T x = square_x(from), y = square_y(from);
+                if (!board[from])
+                    return 0;
+                int dist = 1;
+                if (board[from] > 2)
+                {
+                    if (pos >= size)
+                        return 0;
+                    dist = data[pos++];
+                }
+                else if (x + dx >= 0 && x + dx < 8 && y + dy >= 0 && y + dy < 8 &&
+                         board[square_index(POS_T(x + dx), POS_T(y + dy))])
+                    dist = 2; // шашка ходит на соседнюю клетку или бьёт через неё
+                const int x2 = x + dx * dist, y2 = y + dy * dist;
+                if (dist < 1 || x2 < 0 || x2 > 7 || y2 < 0 || y2 > 7 || board[square_index(POS_T(x2), POS_T(y2))])
+                    return 0;
+                move_pos mv(x, y, POS_T(x2), POS_T(y2));
+                for (int i = 1; i < dist; ++i) // побитая фигура — единственная фигура между клетками шага
+                    if (board[square_index(POS_T(x + dx * i), POS_T(y + dy * i))])
+                    {
+                        mv.xb = POS_T(x + dx * i);
+                        mv.yb = POS_T(y + dy * i);
+                        break;
+                    }
+                play(board, mv);
+                turn.push_back(mv);
+            }
+        }
+        return pos;
+    }
+
+private:
+    // Доска по игровым клеткам: 0 — пусто, 1/2 — шашки, 3/4 — дамки
+    void fill_board(POS_T* board) const
+    {
+        for (int sq = 0; sq < 32; ++sq)
+            board[sq] = POS_T(((white >> sq & 1) ? 1 : (black >> sq & 1) ? 2 : 0) + ((kings >> sq & 1) ? 2 : 0));
+    }
+
+    // Шаг на доске по игровым клеткам (как Logic::make_turn для русских правил)
+    static void play(POS_T* board, const move_pos& turn)
+    {
+        const int from = square_index(turn.x, turn.y), to = square_index(turn.x2, turn.y2);
+        if (turn.xb != -1)
+            board[square_index(turn.xb, turn.yb)] = 0;
+        board[to] = board[from];
+        if ((board[to] == 1 && turn.x2 == 0) || (board[to] == 2 && turn.x2 == 7))
+            board[to] += 2;
+        board[from] = 0;
+    }
+};
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <stdlib.h>
 
 // POS_T — тип для хранения координат клетки на доске (используется int8_t, чтобы экономить память)
@@ -35,3 +36,26 @@ struct move_pos
         return !(*this == other);
     }
 };
+
+// Ход в 16 битах — для таблиц и стеков поиска: биты 0-5 — номер игровой клетки "откуда", 6-11 — "куда"
+// (rules_square, до 64 клеток), 12 — взятие. Побитая фигура не хранится: это единственная фигура между
+// клетками хода, её находит unpack_move по доске (Models/Rules.h). 0 — нет хода.
+struct Packed_move
+{
+    uint16_t bits = 0;
+
+    Packed_move() = default;
+
+    Packed_move(const int from, const int to, const bool capture)
+        : bits(uint16_t(from | to << 6 | int(capture) << 12))
+    {
+    }
+
+    int from() const { return bits & 63; }
+    int to() const { return (bits >> 6) & 63; }
+    bool is_capture() const { return (bits >> 12) & 1; }
+    bool empty() const { return bits == 0; }
+
+    bool operator==(const Packed_move& other) const { return bits == other.bits; }
+    bool operator!=(const Packed_move& other) const { return bits != other.bits; }
+};
@@ -0,0 +1,103 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "Move.h"
+
+// Номер игровой клетки (0..31) по координатам и обратно.
+// Игровые клетки — те, где (x + y) нечётно; в каждом ряду их 4.
+inline int square_index(const POS_T x, const POS_T y)
+{
+    return x * 4 + y / 2;
+}
+
+inline POS_T square_x(const int sq)
+{
+    return POS_T(sq / 4);
+}
+
+inline POS_T square_y(const int sq)
+{
+    return POS_T(2 * (sq % 4) + ((sq / 4) % 2 == 0));
+}
+
+// Результат партии с точки зрения белых (хранится в записи позиции)
+enum Record_result : uint8_t
+{
+    RESULT_BLACK_WIN = 0,
+    RESULT_DRAW = 1,
+    RESULT_WHITE_WIN = 2
+};
+
+// Запись позиции фиксированного размера (16 байт) для данных самоигры и подбора оценки.
+// Битовые маски по 32 игровым клеткам, счёт поиска, лучший ход и итог партии.
+#pragma pack(push, 1)
+struct Position_record
+{
+    uint32_t white = 0;  // фигуры белых
+    uint32_t black = 0;  // фигуры чёрных
+    uint32_t kings = 0;  // какие из фигур — дамки
+    int16_t score = 0;   // оценка поиска для белых (шкала Models/Search.h: логарифм отношения сил * 1000)
+    uint16_t packed = 0; // биты 0-4 — откуда, 5-9 — куда (лучший ход), 10 — очередь (1 = чёрные), 11-12 — итог
+
+    int move_from() const { return packed & 31; }
+    int move_to() const { return (packed >> 5) & 31; }
+    bool side_to_move() const { return (packed >> 10) & 1; }
+    Record_result result() const { return Record_result((packed >> 11) & 3); }
+
+    void set_move(const move_pos& turn)
+    {
+        packed = uint16_t((packed & ~1023u) | square_index(turn.x, turn.y) | (square_index(turn.x2, turn.y2) << 5));
+    }
+
+    void set_side_to_move(const bool color)
+    {
+        packed = uint16_t((packed & ~(1u << 10)) | (unsigned(color) << 10));
+    }
+
+    void set_result(const Record_result res)
+    {
+        packed = uint16_t((packed & ~(3u << 11)) | (unsigned(res) << 11));
+    }
+
+    // Запись оценки поиска для стороны color (Logic::last_score, она помещается в 16 бит)
+    void set_score(const int value, const bool color)
+    {
+        score = int16_t(color ? -value : value);
+    }
+
+    // Упаковка матрицы доски (0 — пусто, 1/2 — шашки, 3/4 — дамки)
+    void set_board(const std::vector<std::vector<POS_T>>& mtx)
+    {
+        white = black = kings = 0;
+        for (int sq = 0; sq < 32; ++sq)
+        {
+            POS_T type = mtx[square_x(sq)][square_y(sq)];
+            if (!type)
+                continue;
+            (type % 2 ? white : black) |= 1u << sq;
+            if (type > 2)
+                kings |= 1u << sq;
+        }
+    }
+
+    std::vector<std::vector<POS_T>> get_board() const
+    {
+        std::vector<std::vector<POS_T>> mtx(8, std::vector<POS_T>(8, 0));
+        for (int sq = 0; sq < 32; ++sq)
+        {
+            POS_T type = 0;
+            if (white >> sq & 1)
+                type = 1;
+            else if (black >> sq & 1)
+                type = 2;
+            if (type && (kings >> sq & 1))
+                type += 2;
+            mtx[square_x(sq)][square_y(sq)] = type;
+        }
+        return mtx;
+    }
+};
+#pragma pack(pop)
+
+static_assert(sizeof(Position_record) == 16, "Position_record must stay 16 bytes");
@@ -8,5 +8,7 @@ enum class Response
     BACK,   // Игрок запросил откат (возврат к предыдущему состоянию/ходу)
     REPLAY, // Игрок запросил перезапуск партии
     QUIT,   // Игрок завершил игру (выход)
-    CELL    // Игрок кликнул по клетке доски (событие выбора клетки)
+    CELL,   // Игрок кликнул по клетке доски (событие выбора клетки)
+    HINT,   // Игрок попросил подсказку (клавиша H)
+    HINT_READY // Подсказка, которая считалась в фоне, готова
 };
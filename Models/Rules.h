@@ -0,0 +1,128 @@
+#pragma once
+#include <vector>
+
+#include "Move.h"
+
+// Правила вариантов шашек — политики времени компиляции для Logic_t<Rules>.
+// Все проверки правил в генераторе ходов и поиске — if constexpr по полям политики, поэтому каждый
+// вариант получает свой генератор без ветвлений на правила во время игры.
+// Белые (шашка 1, дамка 3) ходят к ряду 0, чёрные (2, 4) — к ряду SIZE - 1; игровые клетки — (x + y) нечётно.
+
+// Превращение шашки, дошедшей до дамочного поля во время серии взятий
+enum class Promotion_rule
+{
+    CONTINUE_AS_KING, // сразу становится дамкой и продолжает бить как дамка
+    ENDS_MOVE,        // становится дамкой, серия взятий на этом заканчивается
+    AT_END_ONLY       // становится дамкой, только если серия закончилась на дамочном поле
+};
+
+// Русские шашки: 8x8, дальнобойные дамки, шашки бьют назад
+struct Russian_rules
+{
+    static constexpr POS_T SIZE = 8;                  // размер доски
+    static constexpr bool FLYING_KINGS = true;        // дамка ходит и бьёт на любое расстояние
+    static constexpr bool MEN_CAPTURE_BACKWARD = true; // шашка бьёт и назад
+    static constexpr bool MAJORITY_CAPTURE = false;   // обязательна серия с наибольшим числом взятых фигур
+    static constexpr Promotion_rule PROMOTION = Promotion_rule::CONTINUE_AS_KING;
+    // побитые фигуры снимаются сразу: доску с побитыми фигурами посреди серии пока не умеют рисовать
+    // игра (Board) и оценивать нейросеть и MCTS
+    static constexpr bool CAPTURED_STAY = false;
+    static constexpr const char* NAME = "russian";
+};
+
+// Английские шашки (checkers): дамка ходит на одну клетку, шашки бьют только вперёд
+struct English_rules
+{
+    static constexpr POS_T SIZE = 8;
+    static constexpr bool FLYING_KINGS = false;
+    static constexpr bool MEN_CAPTURE_BACKWARD = false;
+    static constexpr bool MAJORITY_CAPTURE = false;
+    static constexpr Promotion_rule PROMOTION = Promotion_rule::ENDS_MOVE;
+    static constexpr bool CAPTURED_STAY = false;
+    static constexpr const char* NAME = "english";
+};
+
+// Международные шашки: 10x10, дальнобойные дамки, правило большинства
+struct International_rules
+{
+    static constexpr POS_T SIZE = 10;
+    static constexpr bool FLYING_KINGS = true;
+    static constexpr bool MEN_CAPTURE_BACKWARD = true;
+    static constexpr bool MAJORITY_CAPTURE = true;
+    static constexpr Promotion_rule PROMOTION = Promotion_rule::AT_END_ONLY;
+    static constexpr bool CAPTURED_STAY = true; // побитые снимаются после серии (турецкий удар)
+    static constexpr const char* NAME = "international";
+};
+
+// Число игровых клеток варианта
+template <class Rules> constexpr int rules_squares()
+{
+    return Rules::SIZE * Rules::SIZE / 2;
+}
+
+// Номер игровой клетки варианта по координатам (для 8x8 совпадает с square_index)
+template <class Rules> inline int rules_square(const POS_T x, const POS_T y)
+{
+    return x * (Rules::SIZE / 2) + y / 2;
+}
+
+template <class Rules> inline POS_T rules_square_x(const int sq)
+{
+    return POS_T(sq / (Rules::SIZE / 2));
+}
+
+template <class Rules> inline POS_T rules_square_y(const int sq)
+{
+    return POS_T(2 * (sq % (Rules::SIZE / 2)) + ((sq / (Rules::SIZE / 2)) % 2 == 0));
+}
+
+// Упаковка хода в 16 бит (Models/Move.h)
+template <class Rules> inline Packed_move pack_move(const move_pos& turn)
+{
+    return Packed_move(rules_square<Rules>(turn.x, turn.y), rules_square<Rules>(turn.x2, turn.y2), turn.xb != -1);
+}
+
+// Распаковка хода; побитая фигура ищется на доске mtx до хода
+template <class Rules> move_pos unpack_move(const Packed_move move, const std::vector<std::vector<POS_T>>& mtx)
+{
+    move_pos turn(rules_square_x<Rules>(move.from()), rules_square_y<Rules>(move.from()),
+        rules_square_x<Rules>(move.to()), rules_square_y<Rules>(move.to()));
+    if (move.is_capture())
+    {
+        const POS_T dx = (turn.x2 > turn.x ? 1 : -1), dy = (turn.y2 > turn.y ? 1 : -1);
+        for (POS_T x = turn.x + dx, y = turn.y + dy; x != turn.x2; x += dx, y += dy)
+            if (mtx[x][y])
+            {
+                turn.xb = x;
+                turn.yb = y;
+                break;
+            }
+    }
+    return turn;
+}
+
+// Побитая фигура, которая при CAPTURED_STAY остаётся на доске до конца серии взятий: 5 — бьют белые, 6 — чёрные.
+// Чётность та же, что у бьющей фигуры, поэтому генератор видит её своей: её нельзя побить ещё раз,
+// через неё нельзя пройти и на её клетку нельзя встать
+constexpr POS_T captured_marker(const POS_T type)
+{
+    return POS_T(type % 2 ? 5 : 6);
+}
+
+// Стала бы шашка type дамкой на ряду x
+template <class Rules> constexpr bool is_promotion_row(const POS_T type, const POS_T x)
+{
+    return (type == 1 && x == 0) || (type == 2 && x == Rules::SIZE - 1);
+}
+
+// Начальная расстановка: шашки занимают все ряды, кроме двух средних
+template <class Rules> std::vector<std::vector<POS_T>> start_position()
+{
+    const POS_T rows = Rules::SIZE / 2 - 1;
+    std::vector<std::vector<POS_T>> mtx(Rules::SIZE, std::vector<POS_T>(Rules::SIZE, 0));
+    for (POS_T i = 0; i < Rules::SIZE; ++i)
+        for (POS_T j = 0; j < Rules::SIZE; ++j)
+            if ((i + j) % 2 == 1)
+                mtx[i][j] = (i < rows ? 2 : i >= Rules::SIZE - rows ? 1 : 0);
+    return mtx;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <atomic>
+#include <cstdlib>
+#include <vector>
+
+#include "Move.h"
+
+// Оценки поиска — целые числа для стороны, которая ходит (negamax): оценка соперника — та же с минусом.
+// Позиция оценивается логарифмом отношения сил сторон * 1000 (0 — равенство и ничья), не больше SCORE_MAX_EVAL
+// по модулю. Выигрыш — SCORE_WIN минус число полуходов от корня поиска до конца партии, проигрыш — с минусом:
+// поиск предпочитает самый быстрый выигрыш и самый долгий проигрыш.
+const int SCORE_WIN = 32000;
+const int SCORE_INF = SCORE_WIN + 1; // больше любой оценки (границы окна поиска)
+const int SCORE_MAX_EVAL = 30000;
+
+// Выигрыш или проигрыш найден поиском
+inline bool is_decisive_score(const int score)
+{
+    return std::abs(score) > SCORE_MAX_EVAL;
+}
+
+// Полуходов до конца партии для выигрыша/проигрыша
+inline int decisive_distance(const int score)
+{
+    return SCORE_WIN - std::abs(score);
+}
+
+// Ограничения одного поиска (0 — без ограничения)
+struct Search_limits
+{
+    int depth = 0;         // максимальная глубина в полуходах (0 — Logic::Max_depth + 1)
+    long long nodes = 0;   // максимальное число узлов
+    long long time_ms = 0; // максимальное время в миллисекундах
+    const std::atomic<bool>* stop = nullptr; // внешний флаг остановки (выставляется из другого потока)
+};
+
+// Результат очередной итерации углубления поиска
+struct Search_info
+{
+    int depth = 0;             // глубина итерации в полуходах
+    int score = 0;             // оценка лучшего хода для бота
+    long long nodes = 0;       // узлов с начала поиска
+    long long time_ms = 0;     // время с начала поиска
+    std::vector<move_pos> pv;  // главный вариант (серия взятий — несколько ходов подряд)
+};
+
+// Один из лучших ходов корня при анализе нескольких вариантов (Logic::search_multipv)
+struct Search_line
+{
+    std::vector<move_pos> turns; // ход (серия взятий — несколько шагов)
+    int score = 0;               // оценка для ходящего
+    std::vector<move_pos> pv;    // главный вариант, начиная с самого хода
+};
@@ -0,0 +1,60 @@
+#pragma once
+#include <vector>
+
+// Статистика одного поиска (всех итераций углубления вместе)
+struct Search_stats
+{
+    int depth = 0;                   // глубина последней завершённой итерации в полуходах
+    long long time_ms = 0;           // время поиска
+    long long nodes = 0;             // посещённые узлы
+    long long leaves = 0;            // оценки позиций в листьях (calc_score)
+    long long expanded = 0;          // узлы, в которых перебирались ходы
+    long long moves = 0;             // ходов перебрано в этих узлах (считаются и непросмотренные после отсечения)
+    long long cutoffs = 0;           // альфа-бета отсечения
+    long long first_move_cutoffs = 0; // отсечения уже на первом ходе
+    long long tt_probes = 0;         // обращения к таблице транспозиций
+    long long tt_hits = 0;           // найденные записи
+    long long tt_cutoffs = 0;        // узлы, закрытые записью таблицы без перебора
+    long long persistent_hits = 0;   // из них записи, найденные в файловой таблице
+    long long repetitions = 0;       // узлы, оценённые как ничья по повторению позиции
+    std::vector<long long> iteration_ms; // время каждой итерации
+
+    // Средний коэффициент ветвления
+    double branching_factor() const
+    {
+        return expanded ? double(moves) / expanded : 0;
+    }
+
+    // Доля отсечений на первом ходе (качество упорядочивания ходов)
+    double first_move_cutoff_rate() const
+    {
+        return cutoffs ? double(first_move_cutoffs) / cutoffs : 0;
+    }
+
+    double tt_hit_rate() const
+    {
+        return tt_probes ? double(tt_hits) / tt_probes : 0;
+    }
+
+    long long nps() const
+    {
+        return nodes * 1000 / (time_ms > 0 ? time_ms : 1);
+    }
+};
+
+// Статистика одного поиска Монте-Карло (Game/Mcts.h)
+struct Mcts_stats
+{
+    long long time_ms = 0;
+    long long playouts = 0;   // проходов от корня до листа
+    long long tree_nodes = 0; // узлов в дереве после поиска
+    long long reused = 0;     // из них перешло из поиска прошлого хода
+    int max_depth = 0;        // самый длинный путь в дереве (в шагах: шаг серии взятий — отдельно)
+    int threads = 0;
+    bool pool_full = false;   // закончился пул узлов (Bot/MctsMemoryMB): дальше дерево не росло
+
+    long long playouts_per_second() const
+    {
+        return playouts * 1000 / (time_ms > 0 ? time_ms : 1);
+    }
+};
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+
+#include "Move.h"
+
+// Файл записанного дерева поиска (Game/Search_recorder.h, Tools/treestat): заголовок, затем узлы по 16 байт.
+// Узлы итерации идут в обратном порядке обхода (потомки раньше родителя), последним — корень итерации
+// (level 0), поэтому дерево восстанавливается по level одним проходом со стеком. Итерации записываются
+// целиком, так что один файл могут дополнять несколько Logic.
+#pragma pack(push, 1)
+struct Search_tree_header
+{
+    char magic[4] = { 'C', 'K', 'S', 'T' };
+    uint16_t version = 1;
+    uint8_t max_level = 0;    // SearchTreeLevels: узлы глубже не записываются (их узлы поиска — в nodes предков)
+    uint8_t sample_level = 0; // SearchTreeSampleLevel: с этого уровня записывается каждое sample-е поддерево
+    uint32_t sample = 1;      // SearchTreeSample
+    uint32_t reserved = 0;
+};
+
+struct Search_tree_node
+{
+    enum Flags : uint8_t
+    {
+        CHAIN = 1,     // позиция посреди серии взятий (ход в неё — взятие, серия продолжается)
+        TT_CUTOFF = 2, // узел закрыт записью таблицы транспозиций
+        ABORTED = 4,   // у корня: итерация прервана по ограничениям поиска
+        TRUNCATED = 8  // у корня: итерация не поместилась в буфер, часть узлов не записана
+    };
+    static const uint8_t NO_CUTOFF = 0xFF;
+
+    uint32_t nodes = 1;       // узлов поиска в поддереве вместе с самим узлом и незаписанными потомками
+    int16_t alpha = 0;        // окно при входе, для стороны, которая ходит (Models/Search.h)
+    int16_t beta = 0;
+    int16_t score = 0;        // результат узла
+    Packed_move move;         // ход в узел (пустой — передача хода после серии взятий);
+                              // у корня — глубина итерации в полуходах
+    uint8_t level = 0;        // глубина в записанном дереве: 0 — корень итерации
+    uint8_t moves = 0;        // ходов в узле (0 — лист или закрыт без перебора)
+    uint8_t cutoff = NO_CUTOFF; // номер хода, давшего отсечение
+    uint8_t flags = 0;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(Search_tree_header) == 16, "Search_tree_header must stay 16 bytes");
+static_assert(sizeof(Search_tree_node) == 16, "Search_tree_node must stay 16 bytes");
@@ -0,0 +1,96 @@
+#pragma once
+#include <string>
+
+// Настройки из settings.json, разобранные и проверенные один раз (Game/Config.h).
+// Значения по умолчанию совпадают с поставляемым settings.json и берутся, если ключа в файле нет.
+// Настройки ботов хранятся массивами по цвету: [0] — белые, [1] — чёрные.
+
+struct Window_settings
+{
+    int width = 0;  // WindowSize/Width (0 = по умолчанию)
+    int height = 0; // WindowSize/Hight
+    int move_ms = 150; // WindowSize/MoveAnimationMS: анимация хода (0 — без анимации)
+};
+
+// Как понимать уровень бота (Bot/LevelType)
+enum class Level_type
+{
+    DEPTH, // глубина поиска
+    NODES  // бюджет узлов LevelNodes * 4^уровень
+};
+
+// Движок бота (Bot/WhiteBotEngine, BlackBotEngine)
+enum class Engine_type
+{
+    ALPHA_BETA, // "AlphaBeta": перебор Logic
+    MCTS        // "MCTS": поиск Монте-Карло по дереву (Game/Mcts.h)
+};
+
+struct Bot_settings
+{
+    bool is_bot[2] = { false, true };        // IsWhiteBot, IsBlackBot
+    int level[2] = { 0, 5 };                 // WhiteBotLevel, BlackBotLevel
+    Level_type level_type = Level_type::DEPTH;
+    long long level_nodes = 1000;
+    std::string scoring_type = "NumberAndPotential"; // BotScoringType: NumberOnly, NumberAndPotential, NN
+    std::string nn_weights_path = "nn.bin";
+    std::string eval_params_path;
+    long long game_time_ms = 0;
+    long long increment_ms = 0;
+    int delay_ms = 0;                        // BotDelayMS
+    bool no_random = false;
+    int tt_size_mb = 64;
+    std::string persistent_tt_path;
+    int persistent_tt_size_mb = 256;
+    int persistent_tt_min_depth = 6;
+    int solver_max_pieces = 6;
+    long long solver_nodes = 200000;
+    int solver_table_mb = 16;
+    int optimization = 1;                    // номер уровня "O<n>"; 0 — полный перебор без отсечений
+    Engine_type engine[2] = { Engine_type::ALPHA_BETA, Engine_type::ALPHA_BETA }; // WhiteBotEngine, BlackBotEngine
+    long long mcts_time_ms = 1000;           // время хода MCTS, если нет распределения времени на партию
+    int mcts_threads = 0;                    // 0 — по числу ядер
+    int mcts_memory_mb = 256;
+    bool mcts_playouts = false;              // MctsLeaf: "Eval" — оценка листа статической оценкой, "Playout" — доигровкой
+    double mcts_exploration = 1.5;
+};
+
+struct Game_settings
+{
+    int max_turns = 120;        // MaxNumTurns
+    int draw_repetitions = 3;
+    int draw_no_progress = 50;  // DrawNoProgressTurns
+    bool watch_settings = true; // WatchSettings: перечитывать settings.json при изменении
+};
+
+struct Hint_settings
+{
+    int lines = 3;
+    int time_ms = 2000;
+};
+
+struct Log_settings
+{
+    std::string search_log = "search_log.jsonl";
+    std::string game_archive;
+    std::string search_tree;           // SearchTree: запись деревьев поиска бота (пусто — выключена)
+    int search_tree_levels = 8;        // SearchTreeLevels: глубина записанного дерева
+    int search_tree_sample_level = 3;  // SearchTreeSampleLevel
+    int search_tree_sample = 1;        // SearchTreeSample: на уровне SampleLevel записывается каждое N-е поддерево
+};
+
+struct Trace_settings
+{
+    bool enabled = false;
+    std::string path = "trace.json";
+};
+
+struct Settings
+{
+    Window_settings window;
+    Bot_settings bot;
+    Game_settings game;
+    Hint_settings hint;
+    Log_settings log;
+    Trace_settings trace;
+};
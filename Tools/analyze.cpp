@@ -0,0 +1,281 @@
+// Пакетный анализ позиций: оценка, лучший ход и главный вариант для каждой позиции входных файлов.
+// Позиции анализируются параллельно пулом потоков (Game/Thread_pool.h, у каждого потока свой Logic,
+// таблица транспозиций общая), а результаты выводятся строго в порядке входа, по одной JSON-записи на строку.
+// Файлы читаются потоково: в работе одновременно не больше окна позиций (-w), поэтому память не зависит
+// от размера входа.
+//
+// Входные файлы:
+//   *.bin — записи Position_record (например, от Tools/selfplay);
+//   текст — по строке на позицию или партию: "<fen>" или "startpos|<fen> moves m1 m2 ...";
+//           у партии анализируется каждая позиция, в поле played — сделанный в ней ход. Строки с # — комментарии.
+// Запись результата: {"id", "source", "fen", "best", "score", "depth", "nodes", "pv"[, "played"]} или {"id", "source", "error"}.
+// score — логарифм отношения сил стороны, которая ходит, * 1000 (±32000 — найден выигрыш/проигрыш).
+//
+// Запуск: analyze [-j потоки] [-d глубина] [-t movetime] [-tt МБ] [-w окно] [-o результат.jsonl] файл... (- — stdin)
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../Game/Logic.h"
+#include "../Game/Thread_pool.h"
+#include "../Models/Fen.h"
+#include "../Models/Position_record.h"
+
+using namespace std;
+
+struct Analyze_options
+{
+    int threads = max(1u, thread::hardware_concurrency());
+    int depth = 8;
+    long long movetime = 0; // если задано — поиск по времени (глубина не ограничена)
+    int tt_mb = 256;
+    size_t window = 0;      // позиций в работе одновременно (0 — 64 на поток)
+    string out_path;
+    vector<string> inputs;
+};
+
+// Вывод результатов в порядке входа: готовые записи ждут, пока не выведены все предыдущие.
+// Читатель берёт номер для новой позиции через acquire и ждёт, если впереди слишком много невыведенных.
+class Ordered_writer
+{
+public:
+    Ordered_writer(ostream& out, const size_t window) : out(out), window(window)
+    {
+    }
+
+    long long acquire()
+    {
+        unique_lock<mutex> lock(mtx);
+        cv.wait(lock, [this]() { return issued - next < (long long)window; });
+        return issued++;
+    }
+
+    void put(const long long id, string line)
+    {
+        lock_guard<mutex> lock(mtx);
+        pending.emplace(id, move(line));
+        bool advanced = false;
+        for (auto it = pending.begin(); it != pending.end() && it->first == next; it = pending.erase(it))
+        {
+            out << it->second << '\n';
+            ++next;
+            advanced = true;
+        }
+        if (advanced)
+            cv.notify_all();
+    }
+
+    // Ожидание вывода всех выданных записей; возвращает их число
+    long long finish()
+    {
+        unique_lock<mutex> lock(mtx);
+        cv.wait(lock, [this]() { return next == issued; });
+        out.flush();
+        return next;
+    }
+
+private:
+    ostream& out;
+    const size_t window;
+    mutable mutex mtx;
+    condition_variable cv;
+    map<long long, string> pending; // готовые записи, ожидающие предыдущих
+    long long issued = 0;           // выдано номеров
+    long long next = 0;             // номер следующей записи для вывода
+};
+
+class Analyzer
+{
+public:
+    Analyzer(const Analyze_options& opt, Config* config, ostream& out)
+        : opt(opt), writer(out, opt.window), pool(opt.threads), mover(config, false)
+    {
+        auto tt = (opt.tt_mb > 0 ? make_shared<Transposition_table>(opt.tt_mb) : nullptr);
+        for (int i = 0; i < opt.threads; ++i)
+        {
+            logics.emplace_back(new Logic(config, false));
+            logics.back()->set_tt(tt);
+        }
+        limits.depth = (opt.movetime ? 64 : opt.depth);
+        limits.time_ms = opt.movetime;
+    }
+
+    // Чтение файла и постановка его позиций в очередь
+    bool add_file(const string& path)
+    {
+        if (path.size() > 4 && path.substr(path.size() - 4) == ".bin")
+            return add_records(path);
+        if (path == "-")
+            return add_text(cin, "stdin");
+        ifstream fin(path);
+        if (!fin)
+        {
+            cerr << "Error: can't open " << path << "\n";
+            return false;
+        }
+        return add_text(fin, path);
+    }
+
+    long long finish()
+    {
+        return writer.finish();
+    }
+
+private:
+    bool add_records(const string& path)
+    {
+        FILE* fin = fopen(path.c_str(), "rb");
+        if (!fin)
+        {
+            cerr << "Error: can't open " << path << "\n";
+            return false;
+        }
+        vector<Position_record> buf(4096);
+        long long index = 0;
+        size_t n;
+        while ((n = fread(buf.data(), sizeof(Position_record), buf.size(), fin)) > 0)
+            for (size_t i = 0; i < n; ++i, ++index)
+                submit(path + "#" + to_string(index), buf[i].get_board(), buf[i].side_to_move(), "");
+        fclose(fin);
+        return true;
+    }
+
+    bool add_text(istream& in, const string& name)
+    {
+        string line;
+        long long line_num = 0;
+        while (getline(in, line))
+        {
+            ++line_num;
+            stringstream ss(line);
+            string first, word;
+            if (!(ss >> first) || first[0] == '#')
+                continue;
+            const string source = name + ":" + to_string(line_num);
+            vector<vector<POS_T>> mtx;
+            bool color = false;
+            if (!from_fen(first == "startpos" ? start_fen() : first, mtx, color))
+            {
+                error(source, "bad position " + first);
+                continue;
+            }
+            vector<string> moves;
+            if (ss >> word && word == "moves")
+                while (ss >> word)
+                    moves.push_back(word);
+            if (moves.empty())
+            {
+                submit(source, mtx, color, "");
+                continue;
+            }
+            // партия: каждая позиция до хода и итоговая
+            for (size_t ply = 0; ply <= moves.size(); ++ply)
+            {
+                const string played = (ply < moves.size() ? moves[ply] : "");
+                submit(source + ":" + to_string(ply), mtx, color, played);
+                if (ply == moves.size())
+                    break;
+                if (!mover.make_turn_by_squares(mtx, color, parse_move(played)))
+                {
+                    error(source + ":" + to_string(ply), "illegal move " + played);
+                    break;
+                }
+                color = !color;
+            }
+        }
+        return true;
+    }
+
+    void error(const string& source, const string& text)
+    {
+        const long long id = writer.acquire();
+        writer.put(id, json({ { "id", id }, { "source", source }, { "error", text } }).dump());
+    }
+
+    void submit(const string& source, const vector<vector<POS_T>>& mtx, const bool color, const string& played)
+    {
+        const long long id = writer.acquire();
+        pool.submit([this, id, source, mtx, color, played](const int worker) {
+            Logic& logic = *logics[worker];
+            json record = { { "id", id }, { "source", source }, { "fen", to_fen(mtx, color) } };
+            Search_info last;
+            auto best = logic.search(mtx, color, limits, [&last](const Search_info& info) { last = info; });
+            record["best"] = (best.empty() ? string("none") : move_to_string(best));
+            record["score"] = (best.empty() ? -SCORE_WIN : logic.last_score); // для ходящего (Models/Search.h)
+            record["depth"] = logic.get_stats().depth;
+            record["nodes"] = logic.get_stats().nodes;
+            record["pv"] = pv_to_string(last.pv);
+            if (!played.empty())
+                record["played"] = played;
+            writer.put(id, record.dump());
+        });
+    }
+
+    const Analyze_options& opt;
+    Ordered_writer writer;
+    Search_limits limits;
+    vector<unique_ptr<Logic>> logics; // свой Logic у каждого потока пула
+    Thread_pool pool;                 // объявлен после logics: разрушается первым, дожидаясь задач
+    Logic mover;                      // применение ходов партий в потоке чтения
+};
+
+int main(int argc, char* argv[])
+{
+    Analyze_options opt;
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg = argv[i];
+        if (arg == "-j" && i + 1 < argc)
+            opt.threads = max(1, atoi(argv[++i]));
+        else if (arg == "-d" && i + 1 < argc)
+            opt.depth = max(1, atoi(argv[++i]));
+        else if (arg == "-t" && i + 1 < argc)
+            opt.movetime = atoll(argv[++i]);
+        else if (arg == "-tt" && i + 1 < argc)
+            opt.tt_mb = atoi(argv[++i]);
+        else if (arg == "-w" && i + 1 < argc)
+            opt.window = size_t(max(1, atoi(argv[++i])));
+        else if (arg == "-o" && i + 1 < argc)
+            opt.out_path = argv[++i];
+        else
+            opt.inputs.push_back(arg);
+    }
+    if (opt.inputs.empty())
+    {
+        cerr << "Usage: analyze [-j threads] [-d depth] [-t movetime] [-tt MB] [-w window] [-o out.jsonl] input...\n";
+        return 1;
+    }
+    if (!opt.window)
+        opt.window = size_t(opt.threads) * 64;
+
+    ofstream fout;
+    if (!opt.out_path.empty())
+    {
+        fout.open(opt.out_path);
+        if (!fout)
+        {
+            cerr << "Error: can't open " << opt.out_path << "\n";
+            return 1;
+        }
+    }
+
+    Config config; // настройки оценки берутся из settings.json
+    auto start = chrono::steady_clock::now();
+    bool ok = true;
+    Analyzer analyzer(opt, &config, opt.out_path.empty() ? cout : fout);
+    for (const auto& path : opt.inputs)
+        ok = analyzer.add_file(path) && ok;
+    const long long total = analyzer.finish();
+    double sec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    fprintf(stderr, "positions %lld time %.2f s (%.1f per s)\n", total, sec, total / max(sec, 1e-9));
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,90 @@
+// Просмотр архива партий (Game/Game_archive.h), который пишут selfplay -a и игра (Log/GameArchive).
+//   stat — число партий, итоги и длины по оглавлению, размер на диске и скорость полного прохода с распаковкой;
+//   show — партии с номера N (по умолчанию одна) строками "startpos|<fen> moves m1 m2 ..." — их читает Tools/analyze.
+//
+// Запуск: archive stat файл | archive show файл N [число]
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "../Game/Game_archive.h"
+#include "../Models/Fen.h"
+
+using namespace std;
+
+static int print_stat(Game_archive_reader& reader)
+{
+    long long results[3] = { 0, 0, 0 };
+    long long plies = 0, custom = 0;
+    for (uint64_t n = 0; n < reader.size(); ++n) // только оглавление
+    {
+        const auto& info = reader.info(n);
+        ++results[info.result % 3];
+        plies += info.plies;
+        custom += info.flags & 1;
+    }
+    const uint64_t games = reader.size();
+    printf("games %llu  plies %lld (%.1f per game)  from custom positions %lld\n", (unsigned long long)games, plies,
+        games ? double(plies) / games : 0.0, custom);
+    printf("white wins %lld  draws %lld  black wins %lld\n", results[RESULT_WHITE_WIN], results[RESULT_DRAW],
+        results[RESULT_BLACK_WIN]);
+    printf("data %.1f MB (%.1f bytes per game)\n", reader.data_bytes() / 1048576.0,
+        games ? double(reader.data_bytes()) / games : 0.0);
+
+    auto start = chrono::steady_clock::now();
+    long long steps = 0;
+    const uint64_t read = reader.for_each([&](uint64_t, const Game_record& game) {
+        for (const auto& turn : game.turns)
+            steps += turn.size();
+    });
+    const double sec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    printf("scan %llu games, %lld steps in %.2f s (%.0f games/s)\n", (unsigned long long)read, steps, sec,
+        sec > 0 ? read / sec : 0.0);
+    if (read != games)
+    {
+        fprintf(stderr, "Error: %llu games are damaged\n", (unsigned long long)(games - read));
+        return 1;
+    }
+    return 0;
+}
+
+static int show_games(Game_archive_reader& reader, const uint64_t from, const uint64_t count)
+{
+    static const char* result_names[3] = { "0-2", "1-1", "2-0" }; // как Record_result: победа чёрных, ничья, белых
+    Game_record game;
+    for (uint64_t n = from; n < from + count && n < reader.size(); ++n)
+    {
+        if (!reader.read(n, game))
+        {
+            fprintf(stderr, "Error: game %llu is damaged\n", (unsigned long long)n);
+            return 1;
+        }
+        string line = game.is_standard_start() ? "startpos" : to_fen(game.start_board(), game.side);
+        if (!game.turns.empty())
+            line += " moves";
+        for (const auto& turn : game.turns)
+            line += " " + move_to_string(turn);
+        printf("# game %llu result %s\n%s\n", (unsigned long long)n, result_names[game.result % 3], line.c_str());
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    const string command = (argc > 1 ? argv[1] : "");
+    if (argc < 3 || (command != "stat" && command != "show") || (command == "show" && argc < 4))
+    {
+        fprintf(stderr, "Usage: archive stat file | archive show file N [count]\n");
+        return 1;
+    }
+    Game_archive_reader reader;
+    if (!reader.open(argv[2]))
+    {
+        fprintf(stderr, "Error: can't open archive %s\n", argv[2]);
+        return 1;
+    }
+    if (command == "stat")
+        return print_stat(reader);
+    return show_games(reader, strtoull(argv[3], nullptr, 10), argc > 4 ? strtoull(argv[4], nullptr, 10) : 1);
+}
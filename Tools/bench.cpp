@@ -0,0 +1,240 @@
+// Замеры производительности горячих участков движка на фиксированном наборе позиций.
+// Для find_turns, make_turn и оценки позиции (Logic::evaluate) печатает пропускную способность
+// и перцентили задержки одного вызова, для полного поиска — время до каждой глубины (итеративное
+// углубление, таблица транспозиций очищается перед каждым повтором).
+// Результат — JSON (в файл -o или в stdout), краткая сводка — в stderr.
+// С -b сравнивает результат с сохранённым ранее JSON и помечает замедления больше порога
+// (код возврата 2, если они есть).
+//
+// Запуск: bench [-s выборки] [-d мин_глубина] [-D макс_глубина] [-r повторы] [-o результат.json]
+//               [-b базовый.json] [-t порог_%]
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../Game/Logic.h"
+#include "../Models/Fen.h"
+
+using namespace std;
+
+struct Bench_options
+{
+    int samples = 200;  // выборок на замер
+    int batch = 100;    // вызовов в одной выборке
+    int min_depth = 3;
+    int max_depth = 10;
+    int repeats = 3;    // повторов поиска (берётся медиана)
+    string out_path;
+    string baseline_path;
+    double threshold = 10; // допустимое замедление, %
+};
+
+// Набор позиций: дебют, миттельшпиль, позиция с несколькими взятиями, эндшпиль дамок
+const vector<pair<string, string>> corpus = {
+    { "opening", start_fen() },
+    { "middlegame", "W:W19,21,22,25,29,30,31,32:B1,2,4,5,8,10,12,13" },
+    { "captures", "W:W12,17,20,21,23,26,27,29,31:B3,4,5,6,8,10,13,14,16,25" },
+    { "kings", "W:WK18,K27,29,30:BK3,K14,7,9" },
+};
+
+volatile double sink = 0; // чтобы компилятор не выбросил замеряемые вызовы
+
+static double percentile(const vector<double>& sorted, const double p)
+{
+    if (sorted.empty())
+        return 0;
+    return sorted[min(sorted.size() - 1, size_t(p * sorted.size()))];
+}
+
+// Замер функции: samples выборок по batch вызовов, задержка — среднее время вызова в выборке
+static json measure(const Bench_options& opt, const function<void()>& fn)
+{
+    for (int i = 0; i < opt.batch; ++i) // прогрев
+        fn();
+    vector<double> ns;
+    double total_ns = 0;
+    for (int s = 0; s < opt.samples; ++s)
+    {
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < opt.batch; ++i)
+            fn();
+        double t = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+        total_ns += t;
+        ns.push_back(t / opt.batch);
+    }
+    sort(ns.begin(), ns.end());
+    json res;
+    res["ops_per_sec"] = total_ns > 0 ? 1e9 * opt.samples * opt.batch / total_ns : 0;
+    res["p50_ns"] = percentile(ns, 0.5);
+    res["p90_ns"] = percentile(ns, 0.9);
+    res["p99_ns"] = percentile(ns, 0.99);
+    return res;
+}
+
+static json run(const Bench_options& opt, Config* config)
+{
+    Logic logic(config);
+    logic.set_seed(0);
+    const int tt_size_mb = config->settings().bot.tt_size_mb;
+    shared_ptr<Transposition_table> tt;
+    if (tt_size_mb > 0)
+        tt = make_shared<Transposition_table>(tt_size_mb);
+    logic.set_tt(tt);
+
+    json results = json::object();
+    for (const auto& [name, fen] : corpus)
+    {
+        vector<vector<POS_T>> mtx;
+        bool color = false;
+        if (!from_fen(fen, mtx, color))
+        {
+            cerr << "Error: bad position " << name << "\n";
+            continue;
+        }
+
+        results["find_turns/" + name] = measure(opt, [&]() {
+            logic.find_turns(color, mtx);
+            sink = sink + logic.turns.size();
+        });
+
+        logic.find_turns(color, mtx);
+        const vector<move_pos> turns = logic.turns;
+        size_t next = 0;
+        results["make_turn/" + name] = measure(opt, [&]() {
+            auto res = logic.make_turn(mtx, turns[next]);
+            next = (next + 1) % turns.size();
+            sink = sink + res[0][1];
+        });
+
+        results["evaluate/" + name] = measure(opt, [&]() { sink = sink + logic.evaluate(mtx, color); });
+
+        // время до глубины: медиана по повторам
+        vector<vector<double>> depth_ms(opt.max_depth + 1);
+        vector<long long> depth_nodes(opt.max_depth + 1);
+        for (int r = 0; r < opt.repeats; ++r)
+        {
+            if (tt)
+                tt->clear();
+            Search_limits limits;
+            limits.depth = opt.max_depth;
+            auto start = chrono::steady_clock::now();
+            logic.search(mtx, color, limits, [&](const Search_info& info) {
+                depth_ms[info.depth].push_back(
+                    chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+                depth_nodes[info.depth] = info.nodes;
+            });
+        }
+        for (int depth = opt.min_depth; depth <= opt.max_depth; ++depth)
+        {
+            auto& times = depth_ms[depth];
+            if (times.empty()) // поиск закончился раньше (найден выигрыш или ход единственный)
+                continue;
+            sort(times.begin(), times.end());
+            json res;
+            res["time_ms"] = percentile(times, 0.5);
+            res["nodes"] = depth_nodes[depth];
+            results["search/" + name + "/depth_" + to_string(depth)] = res;
+        }
+    }
+    return results;
+}
+
+// Основная метрика замера (чем меньше, тем лучше)
+static double key_metric(const json& res)
+{
+    return res.contains("p50_ns") ? double(res["p50_ns"]) : double(res["time_ms"]);
+}
+
+// Сравнение с базовым результатом; возвращает число замедлений больше порога
+static int compare(const json& base, const json& cur, const double threshold)
+{
+    int regressions = 0;
+    for (auto it = cur.begin(); it != cur.end(); ++it)
+    {
+        if (!base.contains(it.key()))
+            continue;
+        const double before = key_metric(base[it.key()]);
+        const double after = key_metric(it.value());
+        // очень короткие поиски слишком шумные для сравнения
+        if (before <= 0 || (it.value().contains("time_ms") && before < 5))
+            continue;
+        const double change = 100 * (after - before) / before;
+        const bool slower = change > threshold;
+        regressions += slower;
+        fprintf(stderr, "%-36s %12.1f -> %12.1f %+7.1f%%%s\n", it.key().c_str(), before, after, change,
+            slower ? "  REGRESSION" : (change < -threshold ? "  faster" : ""));
+    }
+    return regressions;
+}
+
+int main(int argc, char* argv[])
+{
+    Bench_options opt;
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg = argv[i];
+        if (arg == "-s" && i + 1 < argc)
+            opt.samples = max(1, atoi(argv[++i]));
+        else if (arg == "-d" && i + 1 < argc)
+            opt.min_depth = max(1, atoi(argv[++i]));
+        else if (arg == "-D" && i + 1 < argc)
+            opt.max_depth = max(1, atoi(argv[++i]));
+        else if (arg == "-r" && i + 1 < argc)
+            opt.repeats = max(1, atoi(argv[++i]));
+        else if (arg == "-o" && i + 1 < argc)
+            opt.out_path = argv[++i];
+        else if (arg == "-b" && i + 1 < argc)
+            opt.baseline_path = argv[++i];
+        else if (arg == "-t" && i + 1 < argc)
+            opt.threshold = atof(argv[++i]);
+        else
+        {
+            cerr << "Usage: bench [-s samples] [-d min_depth] [-D max_depth] [-r repeats] [-o out.json]"
+                    " [-b baseline.json] [-t threshold_%]\n";
+            return 1;
+        }
+    }
+
+    json base;
+    if (!opt.baseline_path.empty())
+    {
+        ifstream fin(opt.baseline_path);
+        base = json::parse(fin, nullptr, false);
+        if (!fin || base.is_discarded() || !base.contains("results"))
+        {
+            cerr << "Error: can't load baseline " << opt.baseline_path << "\n";
+            return 1;
+        }
+    }
+
+    Config config;
+    json report;
+    report["version"] = 1;
+    const Bot_settings& bot = config.settings().bot;
+    report["config"] = { { "scoring", bot.scoring_type }, { "optimization", "O" + to_string(bot.optimization) },
+        { "tt_size_mb", bot.tt_size_mb } };
+    report["results"] = run(opt, &config);
+
+    if (opt.out_path.empty())
+        cout << report.dump(2) << endl;
+    else
+    {
+        ofstream fout(opt.out_path);
+        fout << report.dump(2) << endl;
+    }
+
+    if (base.is_null())
+    {
+        for (auto it = report["results"].begin(); it != report["results"].end(); ++it)
+            fprintf(stderr, "%-36s %12.1f\n", it.key().c_str(), key_metric(it.value()));
+        return 0;
+    }
+    const int regressions = compare(base["results"], report["results"], opt.threshold);
+    fprintf(stderr, "%d regression(s) over %.1f%%\n", regressions, opt.threshold);
+    return regressions ? 2 : 0;
+}
@@ -0,0 +1,248 @@
+// Движок с текстовым протоколом (stdin/stdout) для подключения бота без графики.
+// Процесс живёт долго: Logic (веса нейросети, параметры оценки) создаётся один раз и переиспользуется.
+//
+// Команды (по одной в строке):
+//   isready                                   -> readyok
+//   newgame                                   — новая партия (начальная позиция)
+//   position startpos [moves m1 m2 ...]       — позиция из начальной расстановки и ходов
+//   position fen <fen> [moves m1 m2 ...]      — позиция в записи Models/Fen.h
+//   go [depth N] [movetime MS] [nodes N] [multipv K] — поиск; без ограничений — до команды stop
+//   solve [nodes N]                           — доказательство выигрыша стороны, которая ходит (Game/Pn_solver.h)
+//   stop                                      — остановить поиск
+//   fen                                       -> текущая позиция
+//   quit                                      — выход
+// Ответы на go:
+//   info depth D score S nodes N nps X time T pv m1 m2 ...   (после каждой итерации)
+//   info depth D multipv I score S nodes N nps X time T pv ... (при multipv K > 1: I = 1..K, по убыванию оценки)
+//   info stats {...}                                       (статистика поиска в JSON, см. Models/Search_stats.h)
+//   bestmove m                                             (m — ход или серия взятий, например 9x18x27)
+// Ответ на solve:
+//   solve win|nowin|unknown distance D nodes N time T pv m1 m2 ...  (pv — выигрывающий вариант при win)
+// Оценка S — логарифм отношения сил стороны, которая ходит, к сопернику * 1000 ("win"/"loss" — найден итог).
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "../Game/Logger.h"
+#include "../Game/Logic.h"
+#include "../Game/Pn_solver.h"
+#include "../Game/Position_history.h"
+#include "../Models/Fen.h"
+
+using namespace std;
+
+class Engine
+{
+public:
+    explicit Engine(Config* config) : logic(config), solver_logic(config),
+        solver(solver_logic, size_t(config->settings().bot.solver_table_mb))
+    {
+        logic.Max_depth = 0;
+        new_game();
+    }
+
+    ~Engine()
+    {
+        stop();
+    }
+
+    // Обработка одной строки протокола; false — выход
+    bool command(const string& line)
+    {
+        stringstream ss(line);
+        string cmd;
+        ss >> cmd;
+        if (cmd == "quit")
+            return false;
+        if (cmd == "isready")
+            print("readyok");
+        else if (cmd == "newgame")
+        {
+            stop();
+            new_game();
+        }
+        else if (cmd == "position")
+        {
+            stop();
+            position(ss);
+        }
+        else if (cmd == "go")
+        {
+            stop();
+            go(ss);
+        }
+        else if (cmd == "solve")
+        {
+            stop();
+            solve(ss);
+        }
+        else if (cmd == "stop")
+            stop();
+        else if (cmd == "fen")
+            print(to_fen(mtx, color));
+        else if (!cmd.empty())
+            print("error unknown command " + cmd);
+        return true;
+    }
+
+private:
+    void new_game()
+    {
+        from_fen(start_fen(), mtx, color);
+        logic.set_history({});
+    }
+
+    void position(stringstream& ss)
+    {
+        string kind, word;
+        ss >> kind;
+        vector<vector<POS_T>> new_mtx;
+        bool new_color = false;
+        if (kind == "startpos")
+            from_fen(start_fen(), new_mtx, new_color);
+        else if (kind != "fen" || !(ss >> word) || !from_fen(word, new_mtx, new_color))
+        {
+            print("error bad position");
+            return;
+        }
+        Position_history history; // позиции партии до текущей: повторение в поиске — ничья
+        size_t ply = 0;
+        history.set(ply, new_mtx);
+        if (ss >> word && word == "moves")
+        {
+            while (ss >> word)
+            {
+                const auto squares = parse_move(word);
+                if (squares.empty() || !logic.make_turn_by_squares(new_mtx, new_color, squares))
+                {
+                    print("error illegal move " + word);
+                    return;
+                }
+                new_color = !new_color;
+                history.set(++ply, new_mtx);
+            }
+        }
+        mtx = new_mtx;
+        color = new_color;
+        logic.set_history(history.reversible_hashes());
+    }
+
+    void go(stringstream& ss)
+    {
+        Search_limits limits;
+        limits.depth = 64; // без ограничений поиск идёт до stop
+        size_t multipv = 1;
+        string key;
+        long long value;
+        while (ss >> key >> value)
+        {
+            if (key == "multipv")
+                multipv = size_t(max(1LL, value));
+            else if (key == "depth")
+                limits.depth = int(value);
+            else if (key == "movetime")
+                limits.time_ms = value;
+            else if (key == "nodes")
+                limits.nodes = value;
+        }
+        stop_flag = false;
+        limits.stop = &stop_flag;
+
+        if (multipv > 1)
+        {
+            searcher = thread([this, limits, multipv]() {
+                auto lines = logic.search_multipv(mtx, color, multipv, limits,
+                    [this](const Search_info& info, const vector<Search_line>& lines) {
+                        long long nps = info.nodes * 1000 / max(1LL, info.time_ms);
+                        for (size_t i = 0; i < lines.size(); ++i)
+                            print("info depth " + to_string(info.depth) + " multipv " + to_string(i + 1) + " score " +
+                                  score_to_string(lines[i].score) + " nodes " + to_string(info.nodes) + " nps " +
+                                  to_string(nps) + " time " + to_string(info.time_ms) + " pv " +
+                                  pv_to_string(lines[i].pv));
+                    });
+                print("info stats " + Logger::to_json(logic.get_stats()).dump());
+                print(lines.empty() ? "bestmove none" : "bestmove " + move_to_string(lines[0].turns));
+            });
+            return;
+        }
+        searcher = thread([this, limits]() {
+            auto best = logic.search(mtx, color, limits, [this](const Search_info& info) {
+                long long nps = info.nodes * 1000 / max(1LL, info.time_ms);
+                print("info depth " + to_string(info.depth) + " score " + score_to_string(info.score) + " nodes " +
+                      to_string(info.nodes) + " nps " + to_string(nps) + " time " + to_string(info.time_ms) +
+                      " pv " + pv_to_string(info.pv));
+            });
+            print("info stats " + Logger::to_json(logic.get_stats()).dump());
+            print(best.empty() ? "bestmove none" : "bestmove " + move_to_string(best));
+        });
+    }
+
+    void solve(stringstream& ss)
+    {
+        long long nodes = 1000000;
+        string key;
+        long long value;
+        while (ss >> key >> value)
+            if (key == "nodes")
+                nodes = value;
+        stop_flag = false;
+        searcher = thread([this, nodes]() {
+            auto res = solver.solve(mtx, color, nodes, &stop_flag);
+            string pv;
+            for (const auto& turns : res.line)
+                pv += " " + move_to_string(turns);
+            print(string("solve ") +
+                  (res.result == Pn_solver::WIN ? "win" : res.result == Pn_solver::NO_WIN ? "nowin" : "unknown") +
+                  " distance " + to_string(res.distance) + " nodes " + to_string(res.nodes) + " time " +
+                  to_string(res.time_ms) + " pv" + pv);
+        });
+    }
+
+    // Остановка поиска и ожидание bestmove
+    void stop()
+    {
+        stop_flag = true;
+        if (searcher.joinable())
+            searcher.join();
+    }
+
+    // Оценка: число (логарифм отношения сил * 1000) или win/loss N — полуходов до конца партии
+    static string score_to_string(const int score)
+    {
+        if (is_decisive_score(score))
+            return (score > 0 ? "win " : "loss ") + to_string(decisive_distance(score));
+        return to_string(score);
+    }
+
+    void print(const string& text)
+    {
+        lock_guard<mutex> lock(out_mtx);
+        cout << text << endl;
+    }
+
+private:
+    Logic logic;
+    Logic solver_logic; // генератор ходов решателя (Logic поиска может быть занят в потоке)
+    Pn_solver solver;
+    vector<vector<POS_T>> mtx;
+    bool color = false;
+    thread searcher;
+    atomic<bool> stop_flag{ false };
+    mutex out_mtx;
+};
+
+int main()
+{
+    Config config; // настройки оценки берутся из settings.json
+    Engine engine(&config);
+    string line;
+    while (getline(cin, line))
+    {
+        if (!engine.command(line))
+            break;
+    }
+    return 0;
+}
@@ -0,0 +1,209 @@
+// Замер отклика игры без экрана: вся игра (Game) с видеодрайвером SDL dummy (если SDL_VIDEODRIVER не задан),
+// за игрока кликает сценарий. Он ждёт, пока игра попросит ход (Game/Latency_probe.h), выбирает случайный
+// допустимый ход и кликает по фигуре и по клеткам хода, каждый раз дожидаясь кадра с ответом; после партии
+// кликает «повтор», после последней — закрывает игру. Между кликами — пауза «на раздумье».
+// Настройки берутся из settings.json: хотя бы за один цвет должен играть человек.
+// Итог — процентили задержек: клик -> состояние (Board::rerender) -> кадр (SDL_RenderPresent) для кликов
+// и клик -> первый кадр ответа бота.
+//
+// Запуск: latency [-g партии] [-d пауза_мс] [-o out.json]
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../Game/Game.h"
+
+using namespace std;
+
+struct Latency_options
+{
+    int games = 3;
+    int delay_ms = 100; // пауза сценария перед каждым кликом
+    string out;         // JSON с итогами (пусто — только печать)
+};
+
+static void push_event(SDL_Event& event)
+{
+    if (SDL_PushEvent(&event) < 0)
+    {
+        fprintf(stderr, "Error: SDL_PushEvent: %s\n", SDL_GetError());
+        exit(1);
+    }
+}
+
+// Клик по клетке (x — строка, y — столбец; -1 и 8 — поля кнопок), как её понимает Hand::get_cell
+static void click_cell(const Latency_probe::Notice& notice, const int x, const int y, const bool measured = true)
+{
+    SDL_Event event{};
+    event.type = SDL_MOUSEBUTTONDOWN;
+    event.button.button = SDL_BUTTON_LEFT;
+    event.button.state = SDL_PRESSED;
+    event.button.x = (y + 1) * (notice.width / 10) + notice.width / 20;
+    event.button.y = (x + 1) * (notice.height / 10) + notice.height / 20;
+    if (measured)
+        Latency_probe::on_inject();
+    push_event(event);
+}
+
+// Сценарий игрока: случайные допустимые ходы, «повтор» после каждой партии, выход после последней
+static void driver(const Latency_options& opt, Config* config, const atomic<bool>& stop)
+{
+    Logic logic(config, false); // только список допустимых ходов
+    default_random_engine rng(unsigned(time(0)));
+    const auto pause = chrono::milliseconds(opt.delay_ms);
+    const auto wait_frame = chrono::seconds(5);
+    auto click = [&](const Latency_probe::Notice& notice, const int x, const int y) {
+        this_thread::sleep_for(pause);
+        click_cell(notice, x, y);
+        if (!Latency_probe::wait_presented(wait_frame))
+            fprintf(stderr, "Error: no frame within 5 s after a click\n");
+    };
+
+    Latency_probe::Notice notice;
+    uint64_t last_id = 0;
+    int games = 0;
+    while (!stop)
+    {
+        if (!Latency_probe::wait_notice(last_id, notice, chrono::milliseconds(200)))
+            continue;
+        last_id = notice.id;
+        if (notice.type == Latency_probe::Notice::GAME_OVER)
+        {
+            this_thread::sleep_for(pause);
+            if (++games < opt.games)
+                click_cell(notice, -1, 8, false); // «повтор»
+            else
+            {
+                SDL_Event event{};
+                event.type = SDL_QUIT;
+                push_event(event);
+                return;
+            }
+            continue;
+        }
+
+        auto mtx = notice.mtx;
+        logic.find_turns(notice.color, mtx);
+        if (logic.turns.empty())
+            continue;
+        auto turn = logic.turns[rng() % logic.turns.size()];
+        click(notice, turn.x, turn.y);
+        click(notice, turn.x2, turn.y2);
+        while (turn.xb != -1) // серия взятий: клики по следующим клеткам
+        {
+            mtx = logic.make_turn(mtx, turn);
+            logic.find_turns(turn.x2, turn.y2, mtx);
+            if (!logic.have_beats)
+                break;
+            turn = logic.turns[rng() % logic.turns.size()];
+            click(notice, turn.x2, turn.y2);
+        }
+    }
+}
+
+// Процентили интервалов в миллисекундах
+static nlohmann::json percentiles(vector<int64_t> us)
+{
+    nlohmann::json js;
+    js["count"] = us.size();
+    if (us.empty())
+        return js;
+    sort(us.begin(), us.end());
+    auto at = [&](const double p) { return us[min(us.size() - 1, size_t(p * us.size()))] / 1000.0; };
+    js["p50_ms"] = at(0.5);
+    js["p90_ms"] = at(0.9);
+    js["p99_ms"] = at(0.99);
+    js["max_ms"] = us.back() / 1000.0;
+    return js;
+}
+
+int main(int argc, char* argv[])
+{
+    Latency_options opt;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        string arg = argv[i];
+        if (arg == "-g")
+            opt.games = max(1, atoi(argv[i + 1]));
+        else if (arg == "-d")
+            opt.delay_ms = max(0, atoi(argv[i + 1]));
+        else if (arg == "-o")
+            opt.out = argv[i + 1];
+        else
+        {
+            fprintf(stderr, "Usage: latency [-g games] [-d delay_ms] [-o out.json]\n");
+            return 1;
+        }
+    }
+    Config config;
+    if (config.settings().bot.is_bot[0] && config.settings().bot.is_bot[1])
+    {
+        fprintf(stderr, "Error: both sides are bots in settings.json, there is nobody to click for\n");
+        return 1;
+    }
+
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 0); // заданный драйвер (например, offscreen) не меняется
+    Latency_probe::set_enabled(true);
+    atomic<bool> stop{ false };
+    thread script(driver, cref(opt), &config, cref(stop));
+    auto start = chrono::steady_clock::now();
+    {
+        Game game;
+        game.play();
+    }
+    stop = true;
+    script.join();
+    const double sec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    // интервалы: queue — сценарий -> Hand, state — Hand -> Board::rerender, present — Hand -> кадр
+    vector<int64_t> queue_us, state_us[2], present_us[2];
+    for (const auto& sample : Latency_probe::samples())
+    {
+        if (sample.kind == Latency_probe::CLICK && sample.inject_us >= 0)
+            queue_us.push_back(sample.input_us - sample.inject_us);
+        state_us[sample.kind].push_back(sample.state_us - sample.input_us);
+        present_us[sample.kind].push_back(sample.present_us - sample.input_us);
+    }
+    nlohmann::json report;
+    report["games"] = opt.games;
+    report["time_s"] = sec;
+    report["video_driver"] = SDL_getenv("SDL_VIDEODRIVER");
+    report["click"] = { { "queue", percentiles(queue_us) }, { "state", percentiles(state_us[Latency_probe::CLICK]) },
+        { "present", percentiles(present_us[Latency_probe::CLICK]) } };
+    report["bot_reply"] = { { "state", percentiles(state_us[Latency_probe::BOT_REPLY]) },
+        { "present", percentiles(present_us[Latency_probe::BOT_REPLY]) } };
+
+    printf("%d games in %.1f s (video driver %s)\n", opt.games, sec, SDL_getenv("SDL_VIDEODRIVER"));
+    printf("%-22s %7s %9s %9s %9s %9s\n", "interval", "count", "p50 ms", "p90 ms", "p99 ms", "max ms");
+    auto print = [](const char* name, const nlohmann::json& js) {
+        if (js["count"] == 0)
+            printf("%-22s %7d\n", name, 0);
+        else
+            printf("%-22s %7d %9.2f %9.2f %9.2f %9.2f\n", name, js["count"].get<int>(), js["p50_ms"].get<double>(),
+                js["p90_ms"].get<double>(), js["p99_ms"].get<double>(), js["max_ms"].get<double>());
+    };
+    print("click: queue", report["click"]["queue"]);
+    print("click: state", report["click"]["state"]);
+    print("click: present", report["click"]["present"]);
+    print("bot reply: state", report["bot_reply"]["state"]);
+    print("bot reply: present", report["bot_reply"]["present"]);
+
+    if (!opt.out.empty())
+    {
+        ofstream fout(opt.out);
+        fout << report.dump(2) << "\n";
+        if (!fout)
+        {
+            fprintf(stderr, "Error: can't write %s\n", opt.out.c_str());
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,161 @@
+// Генератор нагрузки для Tools/server.
+// Каждое соединение играет партии бот против бота через сервер: отправляет позицию, ждёт ход,
+// применяет его и продолжает, пока партия не закончится. Число одновременных партий = числу соединений.
+// В конце печатает пропускную способность (ходов в секунду) и перцентили задержки ответа.
+//
+// Запуск: loadgen [-p порт] [-c соединения] [-g партий на соединение] [-t movetime] [-d глубина] [-m макс_ходов]
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../Game/Logic.h"
+#include "../Models/Fen.h"
+
+using namespace std;
+
+struct Load_options
+{
+    int port = 7070;
+    int connections = 16;
+    int games = 4;
+    int movetime = 100;
+    int depth = 0;
+    int max_turns = 120;
+};
+
+mutex stats_mtx;
+vector<double> latencies_ms; // задержки всех запросов
+long long errors = 0;
+
+// Чтение одной строки из сокета
+static bool read_line(const int fd, string& buf, string& line)
+{
+    size_t pos;
+    while ((pos = buf.find('\n')) == string::npos)
+    {
+        char chunk[4096];
+        ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+        if (n <= 0)
+            return false;
+        buf.append(chunk, size_t(n));
+    }
+    line = buf.substr(0, pos);
+    buf.erase(0, pos + 1);
+    return true;
+}
+
+static void client(const int id, const Load_options& opt, Config* config)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(uint16_t(opt.port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0)
+    {
+        lock_guard<mutex> lock(stats_mtx);
+        ++errors;
+        return;
+    }
+
+    Logic logic(config, false); // только для применения ходов и проверки конца партии, таблица не нужна
+    vector<double> local;
+    string buf, line;
+    for (int game = 0; game < opt.games; ++game)
+    {
+        vector<vector<POS_T>> mtx;
+        bool color = false;
+        from_fen(start_fen(), mtx, color);
+        for (int turn_num = 0; turn_num < opt.max_turns; ++turn_num)
+        {
+            logic.find_turns(color, mtx);
+            if (logic.turns.empty())
+                break;
+            string request = "search " + to_string(id) + "." + to_string(game) + " " + to_fen(mtx, color);
+            if (opt.movetime)
+                request += " movetime " + to_string(opt.movetime);
+            if (opt.depth)
+                request += " depth " + to_string(opt.depth);
+            request += "\n";
+
+            auto start = chrono::steady_clock::now();
+            send(fd, request.data(), request.size(), MSG_NOSIGNAL);
+            if (!read_line(fd, buf, line))
+            {
+                lock_guard<mutex> lock(stats_mtx);
+                ++errors;
+                close(fd);
+                return;
+            }
+            local.push_back(chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+
+            stringstream ss(line);
+            string word, game_id, move;
+            ss >> word >> game_id >> move;
+            if (word != "result" || !logic.make_turn_by_squares(mtx, color, parse_move(move)))
+            {
+                lock_guard<mutex> lock(stats_mtx);
+                ++errors;
+                break;
+            }
+            color = !color;
+        }
+    }
+    close(fd);
+    lock_guard<mutex> lock(stats_mtx);
+    latencies_ms.insert(latencies_ms.end(), local.begin(), local.end());
+}
+
+int main(int argc, char* argv[])
+{
+    Load_options opt;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        string arg = argv[i];
+        int value = atoi(argv[i + 1]);
+        if (arg == "-p")
+            opt.port = value;
+        else if (arg == "-c")
+            opt.connections = max(1, value);
+        else if (arg == "-g")
+            opt.games = value;
+        else if (arg == "-t")
+            opt.movetime = value;
+        else if (arg == "-d")
+            opt.depth = value;
+        else if (arg == "-m")
+            opt.max_turns = value;
+    }
+
+    Config config;
+    auto start = chrono::steady_clock::now();
+    vector<thread> clients;
+    for (int id = 0; id < opt.connections; ++id)
+        clients.emplace_back(client, id, cref(opt), &config);
+    for (auto& th : clients)
+        th.join();
+    double sec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    sort(latencies_ms.begin(), latencies_ms.end());
+    auto percentile = [](const double p) {
+        if (latencies_ms.empty())
+            return 0.0;
+        return latencies_ms[min(latencies_ms.size() - 1, size_t(p * latencies_ms.size()))];
+    };
+    printf("moves %zu errors %lld time %.2f s\n", latencies_ms.size(), errors, sec);
+    printf("throughput %.1f moves/s\n", latencies_ms.size() / sec);
+    printf("latency ms p50 %.1f p90 %.1f p99 %.1f max %.1f\n", percentile(0.5), percentile(0.9), percentile(0.99),
+        latencies_ms.empty() ? 0.0 : latencies_ms.back());
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,170 @@
+// Матч движков при равном времени на ход: MCTS (Game/Mcts.h) против альфа-беты (Logic::search с итеративным
+// углублением). Партии идут парами с одним случайным дебютом: в первой MCTS играет белыми, во второй — чёрными.
+// Оценка, размер таблицы транспозиций и правила ничьей берутся из settings.json, настройки MCTS — тоже
+// (Bot/Mcts*), кроме числа потоков: по умолчанию у MCTS, как и у альфа-беты, один поток.
+// Итог — победы, ничьи и поражения MCTS, доля очков и средние проходы MCTS и глубина альфа-беты на ход.
+//
+// Запуск: match [-g пары_партий] [-t мс_на_ход] [-j потоки_MCTS] [-r случайные_ходы] [-m макс_ходов]
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../Game/Logic.h"
+#include "../Game/Mcts.h"
+#include "../Game/Position_history.h"
+#include "../Models/Game_record.h"
+
+using namespace std;
+
+struct Match_options
+{
+    int pairs = 10;
+    long long time_ms = 200;
+    int threads = 1; // потоки MCTS
+    int random_plies = 4;
+    int max_turns = 120;
+    int draw_repetitions = 0; // правила ничьей из settings.json (Game)
+    int draw_no_progress = 0;
+};
+
+// Итоги с точки зрения MCTS и средние показатели движков
+struct Match_totals
+{
+    int wins = 0, draws = 0, losses = 0;
+    long long mcts_moves = 0, mcts_playouts = 0;
+    long long ab_moves = 0, ab_depth = 0;
+};
+
+// Случайный дебют: plies полных ходов (серия взятий — целиком)
+static vector<vector<move_pos>> random_opening(Logic& logic, default_random_engine& rng, const int plies)
+{
+    vector<vector<move_pos>> opening;
+    auto mtx = Game_record().start_board();
+    for (int turn_num = 0; turn_num < plies; ++turn_num)
+    {
+        logic.find_turns(bool(turn_num % 2), mtx);
+        if (logic.turns.empty())
+            break;
+        auto turn = logic.turns[rng() % logic.turns.size()];
+        opening.push_back({ turn });
+        mtx = logic.make_turn(mtx, turn);
+        while (turn.xb != -1)
+        {
+            logic.find_turns(turn.x2, turn.y2, mtx);
+            if (!logic.have_beats)
+                break;
+            turn = logic.turns[rng() % logic.turns.size()];
+            opening.back().push_back(turn);
+            mtx = logic.make_turn(mtx, turn);
+        }
+    }
+    return opening;
+}
+
+static Record_result play_game(Logic& logic, Mcts& mcts, const bool mcts_color,
+    const vector<vector<move_pos>>& opening, const Match_options& opt, Match_totals& totals)
+{
+    auto mtx = Game_record().start_board();
+    Position_history history;
+    Search_limits limits;
+    limits.depth = 64;
+    limits.time_ms = opt.time_ms;
+    for (int turn_num = 0; turn_num < opt.max_turns; ++turn_num)
+    {
+        const bool color = turn_num % 2;
+        logic.find_turns(color, mtx);
+        if (logic.turns.empty()) // ходов нет — поражение стороны, которая ходит
+            return color ? RESULT_WHITE_WIN : RESULT_BLACK_WIN;
+        history.set(turn_num, mtx);
+        if ((opt.draw_repetitions && history.repetitions() >= opt.draw_repetitions) ||
+            (opt.draw_no_progress && history.no_progress() >= opt.draw_no_progress))
+            return RESULT_DRAW;
+
+        vector<move_pos> turns;
+        if (turn_num < int(opening.size()))
+            turns = opening[turn_num];
+        else if (color == mcts_color)
+        {
+            turns = mcts.search(mtx, color, limits);
+            ++totals.mcts_moves;
+            totals.mcts_playouts += mcts.get_stats().playouts;
+        }
+        else
+        {
+            logic.set_history(history.reversible_hashes());
+            turns = logic.search(mtx, color, limits);
+            ++totals.ab_moves;
+            totals.ab_depth += logic.get_stats().depth;
+        }
+        for (const auto& turn : turns)
+            mtx = logic.make_turn(mtx, turn);
+    }
+    return RESULT_DRAW;
+}
+
+int main(int argc, char* argv[])
+{
+    Match_options opt;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        string arg = argv[i];
+        if (arg == "-g")
+            opt.pairs = atoi(argv[i + 1]);
+        else if (arg == "-t")
+            opt.time_ms = max(1LL, atoll(argv[i + 1]));
+        else if (arg == "-j")
+            opt.threads = max(1, atoi(argv[i + 1]));
+        else if (arg == "-r")
+            opt.random_plies = atoi(argv[i + 1]);
+        else if (arg == "-m")
+            opt.max_turns = atoi(argv[i + 1]);
+        else
+        {
+            cerr << "Usage: match [-g game_pairs] [-t ms_per_move] [-j mcts_threads] [-r random_plies] [-m max_turns]\n";
+            return 1;
+        }
+    }
+
+    Config config;
+    opt.draw_repetitions = config.settings().game.draw_repetitions;
+    opt.draw_no_progress = config.settings().game.draw_no_progress;
+    Bot_settings bot = config.settings().bot;
+    bot.mcts_threads = opt.threads;
+    Logic logic(&config);
+    Mcts mcts(logic, bot);
+    default_random_engine rng(unsigned(time(0)));
+
+    static const char* result_names[3] = { "0-2", "1-1", "2-0" }; // как Record_result: победа чёрных, ничья, белых
+    Match_totals totals;
+    auto start = chrono::steady_clock::now();
+    for (int pair = 0; pair < opt.pairs; ++pair)
+    {
+        const auto opening = random_opening(logic, rng, opt.random_plies);
+        for (const bool mcts_color : { false, true })
+        {
+            const Record_result res = play_game(logic, mcts, mcts_color, opening, opt, totals);
+            if (res == RESULT_DRAW)
+                ++totals.draws;
+            else if ((res == RESULT_WHITE_WIN) == !mcts_color)
+                ++totals.wins;
+            else
+                ++totals.losses;
+            printf("game %d: MCTS %s %s  (+%d =%d -%d)\n", 2 * pair + mcts_color + 1, mcts_color ? "black" : "white",
+                result_names[res % 3], totals.wins, totals.draws, totals.losses);
+            fflush(stdout);
+        }
+    }
+
+    const int games = totals.wins + totals.draws + totals.losses;
+    const double sec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    printf("MCTS (%d threads) vs AlphaBeta, %lld ms per move: +%d =%d -%d, MCTS score %.1f%%\n", opt.threads,
+        opt.time_ms, totals.wins, totals.draws, totals.losses,
+        games ? 100.0 * (totals.wins + 0.5 * totals.draws) / games : 0.0);
+    printf("MCTS %.0f playouts per move, AlphaBeta depth %.1f per move, %.0f s\n",
+        totals.mcts_moves ? double(totals.mcts_playouts) / totals.mcts_moves : 0.0,
+        totals.ab_moves ? double(totals.ab_depth) / totals.ab_moves : 0.0, sec);
+    return 0;
+}
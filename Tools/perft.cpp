@@ -0,0 +1,125 @@
+// Подсчёт позиций (perft) для проверки генератора ходов вариантов правил (Models/Rules.h).
+// Для каждой глубины 1..D печатает число листьев дерева полных ходов (серия взятий — один ход)
+// из начальной позиции варианта и время. Числа сравниваются с известными значениями варианта.
+// Серии взятий с одинаковыми началом, концом и набором побитых фигур (разный порядок взятий) считаются
+// одним ходом, как и в опубликованных значениях.
+//
+// Запуск: perft [-v russian|english|international] [-d глубина]
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <tuple>
+
+#include "../Game/Logic.h"
+
+using namespace std;
+
+template <class Rules> class Perft
+{
+public:
+    explicit Perft(Config* config) : logic(config)
+    {
+    }
+
+    long long count(const vector<vector<POS_T>>& mtx, const bool color, const int depth)
+    {
+        if (depth == 0)
+            return 1;
+        logic.find_turns(color, mtx);
+        vector<Full_turn> full;
+        expand(mtx, logic.turns, logic.have_beats, -1, 0, full);
+        sort(full.begin(), full.end(), [](const Full_turn& a, const Full_turn& b) { return a.key() < b.key(); });
+        long long total = 0;
+        for (size_t i = 0; i < full.size(); ++i)
+            if (i == 0 || full[i].key() != full[i - 1].key())
+                total += count(full[i].mtx, !color, depth - 1);
+        return total;
+    }
+
+private:
+    // Полный ход: начальная и конечная клетки, побитые фигуры (маска клеток) и позиция после хода
+    struct Full_turn
+    {
+        int from = 0, to = 0;
+        uint64_t captured = 0;
+        vector<vector<POS_T>> mtx;
+
+        tuple<int, int, uint64_t> key() const
+        {
+            return { from, to, captured };
+        }
+    };
+
+    // Полные ходы, начинающиеся ходами turns (серия взятий разворачивается до конца)
+    void expand(const vector<vector<POS_T>>& mtx, const vector<move_pos> turns, const bool have_beats, int from,
+        const uint64_t captured, vector<Full_turn>& out)
+    {
+        for (const auto& turn : turns)
+        {
+            const int start = (from == -1 ? rules_square<Rules>(turn.x, turn.y) : from);
+            const uint64_t now_captured =
+                captured | (turn.xb != -1 ? uint64_t(1) << rules_square<Rules>(turn.xb, turn.yb) : 0);
+            const auto next = logic.make_turn(mtx, turn);
+            if (have_beats && !logic.ends_turn(mtx, turn))
+            {
+                logic.find_turns(turn.x2, turn.y2, next);
+                if (logic.have_beats)
+                {
+                    expand(next, logic.turns, true, start, now_captured, out);
+                    continue;
+                }
+            }
+            Full_turn full;
+            full.from = start;
+            full.to = rules_square<Rules>(turn.x2, turn.y2);
+            full.captured = now_captured;
+            full.mtx = next;
+            out.push_back(move(full));
+        }
+    }
+
+    Logic_t<Rules> logic;
+};
+
+template <class Rules> void run(Config* config, const int max_depth)
+{
+    Perft<Rules> perft(config);
+    const auto mtx = start_position<Rules>();
+    printf("%s\n", Rules::NAME);
+    for (int depth = 1; depth <= max_depth; ++depth)
+    {
+        auto start = chrono::steady_clock::now();
+        const long long nodes = perft.count(mtx, false, depth);
+        double sec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        printf("depth %2d  nodes %12lld  time %8.3f s\n", depth, nodes, sec);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    string variant = "russian";
+    int depth = 6;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!strcmp(argv[i], "-v") && i + 1 < argc)
+            variant = argv[++i];
+        else if (!strcmp(argv[i], "-d") && i + 1 < argc)
+            depth = atoi(argv[++i]);
+    }
+
+    Config config; // NoRandom и прочие настройки берутся из settings.json
+    if (variant == Russian_rules::NAME)
+        run<Russian_rules>(&config, depth);
+    else if (variant == English_rules::NAME)
+        run<English_rules>(&config, depth);
+    else if (variant == International_rules::NAME)
+        run<International_rules>(&config, depth);
+    else
+    {
+        fprintf(stderr, "Usage: perft [-v russian|english|international] [-d depth]\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,226 @@
+// Генератор данных самоигры.
+// Запускает много партий бот против бота без графики в нескольких потоках. Каждая партия начинается
+// со случайного дебюта (несколько случайных ходов), дальше обе стороны ходят поиском Logic.
+// Каждая посещённая позиция сохраняется записью Position_record (16 байт): доска, очередь хода,
+// оценка поиска, лучший ход и итог партии. У каждого потока свой файл <prefix>_<поток>.bin
+// и свой буфер, поэтому потоки не блокируют друг друга. С -a партии целиком (с дебютом) дописываются
+// в общий архив партий (Game/Game_archive.h).
+//
+// Запуск: selfplay [-j потоки] [-g партии] [-d глубина] [-r случайные_ходы] [-m макс_ходов] [-o префикс] [-a архив]
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../Game/Game_archive.h"
+#include "../Game/Logic.h"
+#include "../Game/Position_history.h"
+#include "../Models/Position_record.h"
+
+using namespace std;
+
+struct Selfplay_options
+{
+    int threads = max(1u, thread::hardware_concurrency());
+    int games = 1000;
+    int depth = 4;
+    int random_plies = 6;
+    int max_turns = 120;
+    string prefix = "selfplay";
+    string archive; // пусто — без архива партий
+    int draw_repetitions = 0; // правила ничьей из settings.json (Game)
+    int draw_no_progress = 0;
+};
+
+atomic<long long> games_done{ 0 };
+atomic<long long> positions_done{ 0 };
+
+// Буферизованная запись в файл потока
+class Shard_writer
+{
+public:
+    explicit Shard_writer(const string& path) : fout(fopen(path.c_str(), "wb"))
+    {
+        buf.reserve(BUF_SIZE);
+    }
+
+    ~Shard_writer()
+    {
+        flush();
+        if (fout)
+            fclose(fout);
+    }
+
+    bool is_open() const { return fout != nullptr; }
+
+    void write(const vector<Position_record>& recs)
+    {
+        for (const auto& rec : recs)
+        {
+            buf.push_back(rec);
+            if (buf.size() == BUF_SIZE)
+                flush();
+        }
+    }
+
+    void flush()
+    {
+        if (fout && !buf.empty())
+            fwrite(buf.data(), sizeof(Position_record), buf.size(), fout);
+        buf.clear();
+    }
+
+private:
+    static const size_t BUF_SIZE = 1 << 16; // 1 МБ записей
+    FILE* fout;
+    vector<Position_record> buf;
+};
+
+// Одна партия: возвращает итог, позиции пишутся в recs, ходы — в game
+static Record_result play_game(Logic& logic, default_random_engine& rng, const Selfplay_options& opt,
+    vector<Position_record>& recs, Game_record& game)
+{
+    Position_record start; // начальная расстановка: чёрные на клетках 0..11, белые на 20..31
+    start.black = 0x00000FFFu;
+    start.white = 0xFFF00000u;
+    auto mtx = start.get_board();
+    recs.clear();
+    game.turns.clear();
+    Position_history history;
+
+    for (int turn_num = 0; turn_num < opt.max_turns; ++turn_num)
+    {
+        const bool color = turn_num % 2;
+        logic.find_turns(color, mtx);
+        if (logic.turns.empty()) // ходов нет — поражение стороны, которая ходит
+            return color ? RESULT_WHITE_WIN : RESULT_BLACK_WIN;
+        history.set(turn_num, mtx);
+        if ((opt.draw_repetitions && history.repetitions() >= opt.draw_repetitions) ||
+            (opt.draw_no_progress && history.no_progress() >= opt.draw_no_progress))
+            return RESULT_DRAW;
+        logic.set_history(history.reversible_hashes());
+
+        if (turn_num < opt.random_plies) // случайный дебют, такие позиции не записываются
+        {
+            auto turn = logic.turns[rng() % logic.turns.size()];
+            mtx = logic.make_turn(mtx, turn);
+            game.turns.push_back({ turn });
+            while (turn.xb != -1)
+            {
+                logic.find_turns(turn.x2, turn.y2, mtx);
+                if (!logic.have_beats)
+                    break;
+                turn = logic.turns[rng() % logic.turns.size()];
+                mtx = logic.make_turn(mtx, turn);
+                game.turns.back().push_back(turn);
+            }
+            continue;
+        }
+
+        auto turns = logic.find_best_turns(mtx, color);
+        Position_record rec;
+        rec.set_board(mtx);
+        rec.set_side_to_move(color);
+        rec.set_move(turns[0]);
+        rec.set_score(logic.last_score, color);
+        recs.push_back(rec);
+        for (auto turn : turns)
+            mtx = logic.make_turn(mtx, turn);
+        game.turns.push_back(turns);
+    }
+    return RESULT_DRAW;
+}
+
+static void worker(const int id, const Selfplay_options& opt, Config* config, Game_archive_writer* archive)
+{
+    Shard_writer writer(opt.prefix + "_" + to_string(id) + ".bin");
+    if (!writer.is_open())
+    {
+        cerr << "Error: can't open output for thread " << id << "\n";
+        for (int game = id; game < opt.games; game += opt.threads)
+            ++games_done; // партии потока считаются сыгранными, чтобы main не ждал их вечно
+        return;
+    }
+    Logic logic(config);
+    logic.Max_depth = opt.depth;
+    const unsigned seed = unsigned(time(0)) * 7919u + unsigned(id);
+    logic.set_seed(seed);
+    default_random_engine rng(seed);
+    vector<Position_record> recs;
+    Game_record record;
+
+    // партии раздаются потокам по кругу
+    for (int game = id; game < opt.games; game += opt.threads)
+    {
+        Record_result res = play_game(logic, rng, opt, recs, record);
+        for (auto& rec : recs)
+            rec.set_result(res);
+        writer.write(recs);
+        if (archive)
+        {
+            record.result = res;
+            archive->append(record);
+        }
+        positions_done += recs.size();
+        ++games_done;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Selfplay_options opt;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        string arg = argv[i];
+        if (arg == "-j")
+            opt.threads = max(1, atoi(argv[i + 1]));
+        else if (arg == "-g")
+            opt.games = atoi(argv[i + 1]);
+        else if (arg == "-d")
+            opt.depth = atoi(argv[i + 1]);
+        else if (arg == "-r")
+            opt.random_plies = atoi(argv[i + 1]);
+        else if (arg == "-m")
+            opt.max_turns = atoi(argv[i + 1]);
+        else if (arg == "-o")
+            opt.prefix = argv[i + 1];
+        else if (arg == "-a")
+            opt.archive = argv[i + 1];
+        else
+        {
+            cerr << "Usage: selfplay [-j threads] [-g games] [-d depth] [-r random_plies] [-m max_turns] [-o prefix]"
+                    " [-a archive]\n";
+            return 1;
+        }
+    }
+    Game_archive_writer archive;
+    if (!opt.archive.empty() && !archive.open(opt.archive))
+    {
+        cerr << "Error: can't open archive " << opt.archive << "\n";
+        return 1;
+    }
+
+    Config config; // настройки оценки (BotScoringType, EvalParamsPath, ...) берутся из settings.json
+    opt.draw_repetitions = config.settings().game.draw_repetitions;
+    opt.draw_no_progress = config.settings().game.draw_no_progress;
+    auto start = chrono::steady_clock::now();
+    vector<thread> pool;
+    for (int id = 0; id < opt.threads; ++id)
+        pool.emplace_back(worker, id, cref(opt), &config, archive.is_open() ? &archive : nullptr);
+
+    // прогресс раз в секунду
+    while (games_done < opt.games)
+    {
+        this_thread::sleep_for(chrono::seconds(1));
+        double sec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        printf("games %lld/%d positions %lld (%.0f per min)\n", games_done.load(), opt.games,
+            positions_done.load(), positions_done * 60 / sec);
+        fflush(stdout);
+    }
+    for (auto& th : pool)
+        th.join();
+    return 0;
+}
@@ -0,0 +1,209 @@
+// Сервер поиска для многих партий одновременно (Linux/macOS, TCP на 127.0.0.1).
+// Запросы всех клиентов выполняются общим пулом потоков с перехватом задач (Game/Thread_pool.h):
+// число потоков ограничено, у каждого свой Logic. Таблица транспозиций может быть общей для всех партий.
+//
+// Запуск: server [-p порт] [-j потоки] [-tt МБ общей таблицы (0 — своя таблица у каждого потока)]
+// Протокол (строки):
+//   search <id> <fen> [depth N] [movetime MS] [nodes N]
+//       -> result <id> <ход> score <S> depth <D> nodes <N> time <T>
+//   movetime — крайний срок ответа с момента получения запроса (время в очереди тоже считается);
+//   если срок уже прошёл, ход выбирается поиском на 1 полуход.
+//   stats -> stats served <N> queued <N> threads <N>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../Game/Logic.h"
+#include "../Game/Thread_pool.h"
+#include "../Models/Fen.h"
+
+using namespace std;
+
+// Соединение с клиентом: ответы из разных потоков пула пишутся под мьютексом
+struct Connection
+{
+    explicit Connection(const int fd) : fd(fd)
+    {
+    }
+
+    ~Connection()
+    {
+        close(fd);
+    }
+
+    void send_line(const string& text)
+    {
+        lock_guard<mutex> lock(mtx);
+        string line = text + "\n";
+        size_t sent = 0;
+        while (sent < line.size())
+        {
+            ssize_t n = send(fd, line.data() + sent, line.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0)
+                return;
+            sent += size_t(n);
+        }
+    }
+
+    int fd;
+    mutex mtx;
+};
+
+class Server
+{
+public:
+    Server(Config* config, const int threads, const int shared_tt_mb) : pool(threads)
+    {
+        shared_ptr<Transposition_table> shared_tt;
+        if (shared_tt_mb > 0)
+            shared_tt = make_shared<Transposition_table>(shared_tt_mb);
+        for (int i = 0; i < threads; ++i)
+        {
+            logics.emplace_back(new Logic(config, !shared_tt)); // с общей таблицей своя не создаётся
+            logics.back()->Max_depth = 0;
+            if (shared_tt)
+                logics.back()->set_tt(shared_tt);
+        }
+    }
+
+    // Чтение запросов клиента до закрытия соединения
+    void serve(shared_ptr<Connection> conn)
+    {
+        string buf;
+        char chunk[4096];
+        while (true)
+        {
+            ssize_t n = recv(conn->fd, chunk, sizeof(chunk), 0);
+            if (n <= 0)
+                break;
+            buf.append(chunk, size_t(n));
+            size_t pos;
+            while ((pos = buf.find('\n')) != string::npos)
+            {
+                string line = buf.substr(0, pos);
+                buf.erase(0, pos + 1);
+                request(conn, line);
+            }
+        }
+    }
+
+private:
+    void request(const shared_ptr<Connection>& conn, const string& line)
+    {
+        const auto arrival = chrono::steady_clock::now();
+        stringstream ss(line);
+        string cmd, id, fen;
+        ss >> cmd;
+        if (cmd == "stats")
+        {
+            conn->send_line("stats served " + to_string(served.load()) + " queued " + to_string(pool.queued()) +
+                            " threads " + to_string(pool.size()));
+            return;
+        }
+        vector<vector<POS_T>> mtx;
+        bool color = false;
+        if (cmd != "search" || !(ss >> id >> fen) || !from_fen(fen, mtx, color))
+        {
+            conn->send_line("error bad request");
+            return;
+        }
+        Search_limits limits;
+        limits.depth = 64;
+        string key;
+        long long value;
+        while (ss >> key >> value)
+        {
+            if (key == "depth")
+                limits.depth = int(value);
+            else if (key == "movetime")
+                limits.time_ms = value;
+            else if (key == "nodes")
+                limits.nodes = value;
+        }
+        if (limits.depth == 64 && !limits.time_ms && !limits.nodes)
+            limits.time_ms = 1000; // запрос без ограничений не должен занимать поток навсегда
+
+        pool.submit([this, conn, id, mtx, color, limits, arrival](const int worker) {
+            Search_limits left = limits;
+            if (limits.time_ms)
+            {
+                // крайний срок отсчитывается от получения запроса
+                auto waited = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - arrival);
+                left.time_ms = limits.time_ms - waited.count();
+                if (left.time_ms <= 0)
+                {
+                    left.time_ms = 0;
+                    left.depth = 1;
+                }
+            }
+            Logic& logic = *logics[worker];
+            Search_info last;
+            auto best = logic.search(mtx, color, left, [&last](const Search_info& info) { last = info; });
+            ++served;
+            auto total = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - arrival);
+            conn->send_line("result " + id + " " + (best.empty() ? string("none") : move_to_string(best)) +
+                            " score " + to_string(logic.last_score) + " depth " +
+                            to_string(last.depth) + " nodes " + to_string(logic.get_nodes()) + " time " +
+                            to_string(total.count()));
+        });
+    }
+
+    Thread_pool pool;
+    vector<unique_ptr<Logic>> logics; // свой Logic у каждого потока пула
+    atomic<long long> served{ 0 };
+};
+
+int main(int argc, char* argv[])
+{
+    int port = 7070;
+    int threads = max(1u, thread::hardware_concurrency());
+    int shared_tt_mb = 256;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        string arg = argv[i];
+        if (arg == "-p")
+            port = atoi(argv[i + 1]);
+        else if (arg == "-j")
+            threads = max(1, atoi(argv[i + 1]));
+        else if (arg == "-tt")
+            shared_tt_mb = atoi(argv[i + 1]);
+    }
+
+    int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    int yes = 1;
+    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(uint16_t(port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (listen_fd < 0 || bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        listen(listen_fd, 64) != 0)
+    {
+        cerr << "Error: can't listen on 127.0.0.1:" << port << "\n";
+        return 1;
+    }
+
+    Config config; // настройки оценки берутся из settings.json
+    Server server(&config, threads, shared_tt_mb);
+    cout << "Listening on 127.0.0.1:" << port << ", " << threads << " threads" << endl;
+    while (true)
+    {
+        int fd = accept(listen_fd, nullptr, nullptr);
+        if (fd < 0)
+            continue;
+        auto conn = make_shared<Connection>(fd);
+        thread([&server, conn]() { server.serve(conn); }).detach();
+    }
+    return 0;
+}
@@ -0,0 +1,297 @@
+// Разбор записанных деревьев поиска (Log/SearchTree, Game/Search_recorder.h):
+//   - итерации — сколько записано, прерванных и не поместившихся в буфер, эффективный коэффициент ветвления
+//     по глубине итерации (отношение узлов итерации к узлам предыдущей в том же поиске);
+//   - по глубине дерева (полные ходы от корня) — узлы, отсечения по таблице, среднее число ходов и сколько
+//     из них перебиралось, эффективный коэффициент ветвления (отношение средних размеров поддеревьев этой
+//     и следующей глубины в одной итерации — счётчик узлов полный и ниже записанных уровней) и гистограмма
+//     номера хода, давшего отсечение (чем дальше от нулевого, тем хуже упорядочены ходы);
+//   - самые дорогие поддеревья уровней 1..l: узлы поиска, доля итерации, окно, оценка и путь от корня.
+// Узлы поддеревьев, записанных выборкой (SearchTreeSample), учитываются с весом N.
+//
+// Запуск: treestat файл [-n число_поддеревьев] [-l уровень]
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../Models/Search_tree.h"
+
+using namespace std;
+
+static const int CUTOFF_BUCKETS = 6; // номер хода отсечения: 0, 1, 2, 3, 4-7, 8+
+static const char* bucket_names[CUTOFF_BUCKETS] = { "0", "1", "2", "3", "4-7", "8+" };
+
+static int cutoff_bucket(const int index)
+{
+    if (index < 4)
+        return index;
+    return index < 8 ? 4 : 5;
+}
+
+// Счётчики по глубине дерева (с весом выборки)
+struct Depth_totals
+{
+    double nodes = 0;
+    double tt_cutoffs = 0;
+    double expanded = 0;
+    double generated = 0; // ходов в раскрытых узлах
+    double searched = 0;  // из них перебрано до отсечения
+    double cutoffs[CUTOFF_BUCKETS] = {};
+    double branching_log = 0; // сумма логарифмов коэффициента ветвления по итерациям
+    int branching_count = 0;
+};
+
+struct Subtree
+{
+    uint32_t nodes = 0;
+    double share = 0; // доля узлов итерации
+    int plies = 0;    // глубина итерации
+    Search_tree_node node;
+    string path;
+};
+
+struct Tree_totals
+{
+    long long iterations = 0, aborted = 0, truncated = 0, recorded = 0;
+    vector<Depth_totals> depths;
+    map<int, pair<double, int>> iteration_ratio; // глубина итерации -> сумма логарифмов отношения узлов, число
+    vector<Subtree> top;
+};
+
+// Ход в узел: клетки 1..32 (Models/Fen.h); continued — следующее взятие той же серии
+static string move_text(const Packed_move move, const bool continued)
+{
+    if (move.empty())
+        return string();
+    const string to = to_string(move.to() + 1);
+    if (continued)
+        return "x" + to;
+    return to_string(move.from() + 1) + (move.is_capture() ? "x" : "-") + to;
+}
+
+static string node_path(const vector<Search_tree_node>& tree, const vector<int>& parent, int i)
+{
+    vector<string> moves;
+    for (; parent[i] >= 0; i = parent[i])
+        moves.push_back(move_text(tree[i].move, tree[parent[i]].flags & Search_tree_node::CHAIN));
+    string res;
+    for (auto it = moves.rbegin(); it != moves.rend(); ++it)
+    {
+        if (!res.empty() && !it->empty() && (*it)[0] != 'x')
+            res += ' ';
+        res += *it;
+    }
+    return res;
+}
+
+// Одна итерация: узлы в обратном порядке обхода, последний — корень
+static void add_iteration(const vector<Search_tree_node>& tree, const Search_tree_header& header,
+    const int top_count, const int top_level, Tree_totals& totals)
+{
+    const int count = int(tree.size());
+    const Search_tree_node& root = tree.back();
+    ++totals.iterations;
+    totals.aborted += (root.flags & Search_tree_node::ABORTED) != 0;
+    totals.truncated += (root.flags & Search_tree_node::TRUNCATED) != 0;
+    totals.recorded += count;
+
+    // родитель узла — ближайший следующий за ним узел уровнем выше
+    vector<int> parent(count, -1), stack;
+    for (int i = 0; i < count; ++i)
+    {
+        while (!stack.empty() && tree[stack.back()].level == tree[i].level + 1)
+        {
+            parent[stack.back()] = i;
+            stack.pop_back();
+        }
+        stack.push_back(i);
+    }
+
+    vector<int> depth(count, 0);
+    vector<double> subtree_nodes; // по глубине: сумма размеров поддеревьев записанных узлов и их число
+    vector<int> subtree_count;
+    for (int i = count - 1; i >= 0; --i) // родитель всегда позже потомков
+    {
+        const Search_tree_node& node = tree[i];
+        if (parent[i] >= 0)
+            depth[i] = depth[parent[i]] + !(node.flags & Search_tree_node::CHAIN);
+        if (int(totals.depths.size()) <= depth[i])
+            totals.depths.resize(depth[i] + 1);
+        if (int(subtree_nodes.size()) <= depth[i])
+        {
+            subtree_nodes.resize(depth[i] + 1);
+            subtree_count.resize(depth[i] + 1);
+        }
+        subtree_nodes[depth[i]] += node.nodes;
+        ++subtree_count[depth[i]];
+        const double weight = (header.sample > 1 && node.level >= header.sample_level ? header.sample : 1);
+        Depth_totals& d = totals.depths[depth[i]];
+        d.nodes += weight;
+        if (node.flags & Search_tree_node::TT_CUTOFF)
+            d.tt_cutoffs += weight;
+        if (node.moves)
+        {
+            d.expanded += weight;
+            d.generated += weight * node.moves;
+            if (node.cutoff != Search_tree_node::NO_CUTOFF)
+            {
+                d.searched += weight * (node.cutoff + 1);
+                d.cutoffs[cutoff_bucket(node.cutoff)] += weight;
+            }
+            else
+                d.searched += weight * node.moves;
+        }
+
+        if (node.level < 1 || node.level > top_level || !top_count)
+            continue;
+        auto less_nodes = [](const Subtree& a, const Subtree& b) { return a.nodes > b.nodes; };
+        if (int(totals.top.size()) == top_count && node.nodes <= totals.top.front().nodes)
+            continue;
+        Subtree sub;
+        sub.nodes = node.nodes;
+        sub.share = double(node.nodes) / max<uint32_t>(root.nodes, 1);
+        sub.plies = root.move.bits;
+        sub.node = node;
+        sub.path = node_path(tree, parent, i);
+        if (int(totals.top.size()) == top_count)
+        {
+            pop_heap(totals.top.begin(), totals.top.end(), less_nodes);
+            totals.top.pop_back();
+        }
+        totals.top.push_back(sub);
+        push_heap(totals.top.begin(), totals.top.end(), less_nodes);
+    }
+
+    for (size_t d = 0; d + 1 < subtree_nodes.size(); ++d)
+    {
+        if (!subtree_count[d] || !subtree_count[d + 1])
+            continue;
+        const double here = subtree_nodes[d] / subtree_count[d], next = subtree_nodes[d + 1] / subtree_count[d + 1];
+        totals.depths[d].branching_log += log(here / next);
+        ++totals.depths[d].branching_count;
+    }
+}
+
+static string score_text(const int score)
+{
+    if (abs(score) >= 32001) // SCORE_INF
+        return score > 0 ? "inf" : "-inf";
+    return to_string(score);
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "Usage: treestat file [-n top_subtrees] [-l max_level]\n");
+        return 1;
+    }
+    int top_count = 10, top_level = 3;
+    for (int i = 2; i + 1 < argc; i += 2)
+    {
+        string arg = argv[i];
+        if (arg == "-n")
+            top_count = max(0, atoi(argv[i + 1]));
+        else if (arg == "-l")
+            top_level = max(1, atoi(argv[i + 1]));
+        else
+        {
+            fprintf(stderr, "Usage: treestat file [-n top_subtrees] [-l max_level]\n");
+            return 1;
+        }
+    }
+
+    FILE* fin = fopen(argv[1], "rb");
+    if (!fin)
+    {
+        fprintf(stderr, "Error: can't open %s\n", argv[1]);
+        return 1;
+    }
+    Search_tree_header header, expected;
+    if (fread(&header, sizeof(header), 1, fin) != 1 || string(header.magic, 4) != string(expected.magic, 4) ||
+        header.version != expected.version)
+    {
+        fprintf(stderr, "Error: %s is not a search tree file\n", argv[1]);
+        fclose(fin);
+        return 1;
+    }
+
+    Tree_totals totals;
+    vector<Search_tree_node> tree;
+    Search_tree_node node;
+    int prev_plies = 0;
+    uint32_t prev_nodes = 0;
+    while (fread(&node, sizeof(node), 1, fin) == 1)
+    {
+        tree.push_back(node);
+        if (node.level != 0)
+            continue;
+        // итерации одного поиска идут подряд с глубиной на 1 больше
+        const int plies = node.move.bits;
+        if (plies == prev_plies + 1 && prev_nodes && node.nodes && !(node.flags & Search_tree_node::ABORTED))
+        {
+            auto& ratio = totals.iteration_ratio[plies];
+            ratio.first += log(double(node.nodes) / prev_nodes);
+            ++ratio.second;
+        }
+        prev_plies = plies;
+        prev_nodes = node.nodes;
+        add_iteration(tree, header, top_count, top_level, totals);
+        tree.clear();
+    }
+    fclose(fin);
+    if (!tree.empty())
+        printf("warning: %zu nodes after the last iteration root are ignored (file cut off)\n", tree.size());
+
+    printf("%lld iterations (%lld aborted, %lld truncated), %lld nodes recorded; levels %d, sample 1/%u from level %d\n",
+        totals.iterations, totals.aborted, totals.truncated, totals.recorded, header.max_level, header.sample,
+        header.sample_level);
+    if (!totals.iteration_ratio.empty())
+    {
+        printf("\niteration depth -> effective branching factor (geometric mean of nodes(d) / nodes(d-1))\n");
+        for (const auto& [plies, ratio] : totals.iteration_ratio)
+            printf("%5d  %6.2f  (%d searches)\n", plies, exp(ratio.first / ratio.second), ratio.second);
+    }
+
+    printf("\n%5s %10s %7s %9s %7s %8s %9s", "depth", "nodes", "tt cut", "expanded", "moves", "searched",
+        "branching");
+    for (const char* name : bucket_names)
+        printf(" %6s", name);
+    printf("   (cutoff index, %% of cutoffs)\n");
+    for (size_t d = 0; d < totals.depths.size(); ++d)
+    {
+        const Depth_totals& t = totals.depths[d];
+        double cutoffs = 0;
+        for (const double c : t.cutoffs)
+            cutoffs += c;
+        printf("%5zu %10.0f %6.1f%% %9.0f %7.2f %8.2f", d, t.nodes, t.nodes ? 100 * t.tt_cutoffs / t.nodes : 0.0,
+            t.expanded, t.expanded ? t.generated / t.expanded : 0.0, t.expanded ? t.searched / t.expanded : 0.0);
+        if (t.branching_count)
+            printf(" %9.2f", exp(t.branching_log / t.branching_count));
+        else
+            printf(" %9s", "-");
+        for (const double c : t.cutoffs)
+            printf(" %5.1f%%", cutoffs ? 100 * c / cutoffs : 0.0);
+        printf("\n");
+    }
+
+    if (totals.top.empty())
+        return 0;
+    sort(totals.top.begin(), totals.top.end(), [](const Subtree& a, const Subtree& b) { return a.nodes > b.nodes; });
+    printf("\nmost expensive subtrees (levels 1..%d)\n", top_level);
+    printf("%10s %6s %5s %13s %6s %5s %6s  %s\n", "nodes", "share", "plies", "window", "score", "moves", "cutoff",
+        "path");
+    for (const auto& sub : totals.top)
+    {
+        const string window = "[" + score_text(sub.node.alpha) + "," + score_text(sub.node.beta) + "]";
+        const string cutoff = (sub.node.flags & Search_tree_node::TT_CUTOFF ? "tt"
+            : sub.node.cutoff == Search_tree_node::NO_CUTOFF           ? "-"
+                                                                       : to_string(sub.node.cutoff));
+        printf("%10u %5.1f%% %5d %13s %6d %5d %6s  %s\n", sub.nodes, 100 * sub.share, sub.plies, window.c_str(),
+            sub.node.score, sub.node.moves, cutoff.c_str(), sub.path.c_str());
+    }
+    return 0;
+}
@@ -0,0 +1,230 @@
+// Утилита подбора параметров оценки (Texel tuning).
+// Читает позиции самоигры (Models/Position_record.h), для каждой считает признаки сторон один раз,
+// а затем минимизирует квадрат ошибки между итогом партии и предсказанием
+//     p(белые) = sigmoid(K * ln(W / B)),
+// где W и B — сила белых и чёрных из Logic::calc_score (она линейна по параметрам).
+// Градиент по всем позициям считается параллельно во всех потоках, шаги делает Adam.
+//
+// Запуск: tune [-j потоки] [-e эпохи] [-lr шаг] [-i начальные.json] [-o результат.json] data1.bin [data2.bin ...]
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../Models/Eval_params.h"
+#include "../Models/Position_record.h"
+
+using namespace std;
+
+const int NF = Eval_params::N + 1; // признаков на сторону (константа + параметры)
+
+// Позиция, сведённая к суммам признаков по сторонам
+struct Sample
+{
+    uint8_t f[2][NF]; // [0] — белые, [1] — чёрные
+    uint8_t result;   // 0 — победа чёрных, 1 — ничья, 2 — победа белых
+};
+
+// Признаки стороны из битовой маски её фигур
+static void side_features(const uint32_t pieces, const uint32_t kings, const POS_T man_type, uint8_t out[NF])
+{
+    double sum[NF] = {};
+    for (int sq = 0; sq < 32; ++sq)
+    {
+        if (!(pieces >> sq & 1))
+            continue;
+        double f[NF];
+        Eval_params::piece_features((kings >> sq & 1) ? man_type + 2 : man_type, square_x(sq), square_y(sq), f);
+        for (int k = 0; k < NF; ++k)
+            sum[k] += f[k];
+    }
+    for (int k = 0; k < NF; ++k)
+        out[k] = uint8_t(sum[k]);
+}
+
+// Чтение всех файлов с позициями; позиции без фигур у одной из сторон пропускаются
+static bool load_samples(const vector<string>& paths, vector<Sample>& samples)
+{
+    const size_t CHUNK = 1 << 16;
+    vector<Position_record> buf(CHUNK);
+    for (const auto& path : paths)
+    {
+        ifstream fin(path, ios::binary);
+        if (!fin)
+        {
+            cerr << "Error: can't open " << path << "\n";
+            return false;
+        }
+        while (fin)
+        {
+            fin.read(reinterpret_cast<char*>(buf.data()), CHUNK * sizeof(Position_record));
+            size_t n = size_t(fin.gcount()) / sizeof(Position_record);
+            for (size_t i = 0; i < n; ++i)
+            {
+                const Position_record& rec = buf[i];
+                if (!rec.white || !rec.black)
+                    continue;
+                Sample s;
+                side_features(rec.white, rec.kings, 1, s.f[0]);
+                side_features(rec.black, rec.kings, 2, s.f[1]);
+                s.result = rec.result();
+                samples.push_back(s);
+            }
+        }
+    }
+    return true;
+}
+
+// Параллельная сумма: func(begin, end, acc) накапливает результат по своему куску в acc[0..width)
+static vector<double> parallel_sum(const size_t n, const int threads, const size_t width,
+    const function<void(size_t, size_t, double*)>& func)
+{
+    vector<vector<double>> partial(threads, vector<double>(width, 0));
+    vector<thread> pool;
+    for (int t = 0; t < threads; ++t)
+    {
+        size_t begin = n * t / threads, end = n * (t + 1) / threads;
+        pool.emplace_back(func, begin, end, partial[t].data());
+    }
+    for (auto& th : pool)
+        th.join();
+    vector<double> total(width, 0);
+    for (auto& p : partial)
+        for (size_t k = 0; k < width; ++k)
+            total[k] += p[k];
+    return total;
+}
+
+// Сила стороны при заданных параметрах
+static inline double strength(const uint8_t f[NF], const Eval_params& params)
+{
+    double value = f[0];
+    for (int k = 0; k < Eval_params::N; ++k)
+        value += f[k + 1] * params[k];
+    return max(value, 1e-3);
+}
+
+// Средняя ошибка и (если grad != nullptr) её градиент по параметрам
+static double calc_error(const vector<Sample>& samples, const Eval_params& params, const double K,
+    const int threads, double* grad)
+{
+    const size_t width = 1 + Eval_params::N;
+    auto total = parallel_sum(samples.size(), threads, width, [&](size_t begin, size_t end, double* acc) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            const Sample& s = samples[i];
+            double W = strength(s.f[0], params), B = strength(s.f[1], params);
+            double p = 1 / (1 + exp(-K * (log(W) - log(B))));
+            double r = s.result * 0.5;
+            acc[0] += (r - p) * (r - p);
+            if (!grad)
+                continue;
+            double d = -2 * (r - p) * p * (1 - p) * K;
+            for (int k = 0; k < Eval_params::N; ++k)
+                acc[1 + k] += d * (s.f[0][k + 1] / W - s.f[1][k + 1] / B);
+        }
+    });
+    const double n = double(max<size_t>(samples.size(), 1));
+    if (grad)
+        for (int k = 0; k < Eval_params::N; ++k)
+            grad[k] = total[1 + k] / n;
+    return total[0] / n;
+}
+
+// Подбор масштаба K (золотое сечение) при фиксированных параметрах
+static double fit_scale(const vector<Sample>& samples, const Eval_params& params, const int threads)
+{
+    double lo = 0.1, hi = 20;
+    const double phi = (sqrt(5.0) - 1) / 2;
+    for (int it = 0; it < 40; ++it)
+    {
+        double a = hi - phi * (hi - lo), b = lo + phi * (hi - lo);
+        if (calc_error(samples, params, a, threads, nullptr) < calc_error(samples, params, b, threads, nullptr))
+            hi = b;
+        else
+            lo = a;
+    }
+    return (lo + hi) / 2;
+}
+
+int main(int argc, char* argv[])
+{
+    int threads = max(1u, thread::hardware_concurrency());
+    int epochs = 300;
+    double lr = 0.01;
+    string init_path, out_path = "eval_params.json";
+    vector<string> inputs;
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg = argv[i];
+        if (arg == "-j" && i + 1 < argc)
+            threads = max(1, atoi(argv[++i]));
+        else if (arg == "-e" && i + 1 < argc)
+            epochs = atoi(argv[++i]);
+        else if (arg == "-lr" && i + 1 < argc)
+            lr = atof(argv[++i]);
+        else if (arg == "-i" && i + 1 < argc)
+            init_path = argv[++i];
+        else if (arg == "-o" && i + 1 < argc)
+            out_path = argv[++i];
+        else
+            inputs.push_back(arg);
+    }
+    if (inputs.empty())
+    {
+        cerr << "Usage: tune [-j threads] [-e epochs] [-lr step] [-i init.json] [-o out.json] data.bin...\n";
+        return 1;
+    }
+
+    auto start = chrono::steady_clock::now();
+    vector<Sample> samples;
+    if (!load_samples(inputs, samples))
+        return 1;
+    cout << "Loaded " << samples.size() << " positions in "
+         << chrono::duration<double>(chrono::steady_clock::now() - start).count() << " s\n";
+
+    Eval_params params = Eval_params::defaults("NumberAndPotential");
+    if (!init_path.empty() && !params.load(init_path))
+    {
+        cerr << "Error: can't load " << init_path << "\n";
+        return 1;
+    }
+
+    const double K = fit_scale(samples, params, threads);
+    cout << "Scale K = " << K << ", start error = " << calc_error(samples, params, K, threads, nullptr) << "\n";
+
+    // Adam
+    double m[Eval_params::N] = {}, v[Eval_params::N] = {}, grad[Eval_params::N];
+    const double beta1 = 0.9, beta2 = 0.999, eps = 1e-8;
+    for (int epoch = 1; epoch <= epochs; ++epoch)
+    {
+        double err = calc_error(samples, params, K, threads, grad);
+        for (int k = 0; k < Eval_params::N; ++k)
+        {
+            m[k] = beta1 * m[k] + (1 - beta1) * grad[k];
+            v[k] = beta2 * v[k] + (1 - beta2) * grad[k] * grad[k];
+            double mh = m[k] / (1 - pow(beta1, epoch)), vh = v[k] / (1 - pow(beta2, epoch));
+            params[k] -= lr * mh / (sqrt(vh) + eps);
+        }
+        params.king = max(params.king, 0.1); // дамка не может стоить меньше нуля
+        if (epoch % 25 == 0 || epoch == epochs)
+            printf("epoch %d error %.6f king %.4f advance %.4f back_rank %.4f center %.4f\n", epoch, err,
+                params.king, params.advance, params.back_rank, params.center);
+    }
+
+    if (!params.save(out_path))
+    {
+        cerr << "Error: can't write " << out_path << "\n";
+        return 1;
+    }
+    cout << "Saved " << out_path << " in " << chrono::duration<double>(chrono::steady_clock::now() - start).count()
+         << " s\n";
+    return 0;
+}